@@ -0,0 +1,38 @@
+/* The ascii.h helpers against the stringops.h functions they replace. See bench.h for building; add src/ascii.cpp. */
+#include "bench.h"
+#include "../src/ascii.h"
+#include <dpp/stringops.h>
+#include <string>
+
+int main() {
+    const std::string message = "!Ping The Bot And Ask It For The Server STATS, Please. Thanks!";
+    const std::string number = "1234567";
+    const size_t iterations = 200000;
+
+    std::printf( "Folding a %zu-byte message, per call:\n", message.size() );
+    bench::report( "lowercase()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       bench::keep( ::lowercase( message ).size() );
+                   } ) );
+    bench::report( "mybot::to_ascii_lower()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       bench::keep( mybot::to_ascii_lower( message ).size() );
+                   } ) );
+
+    std::printf( "Formatting 1234567 with separators, per call:\n" );
+    bench::report( "Comma()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       bench::keep( ::Comma( 1234567 ).size() );
+                   } ) );
+    bench::report( "mybot::format_thousands()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       bench::keep( mybot::format_thousands( 1234567 ).size() );
+                   } ) );
+
+    std::printf( "Parsing \"%s\" as int, per call:\n", number.c_str() );
+    bench::report( "from_string<int>()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       bench::keep( ::from_string<int>( number, std::dec ) );
+                   } ) );
+    bench::report( "mybot::parse_number<int>()", bench::ns_per_op( iterations, [&]( size_t ) {
+                       int v = 0;
+                       mybot::parse_number( number, v );
+                       bench::keep( v );
+                   } ) );
+    return 0;
+}
@@ -0,0 +1,56 @@
+#pragma once
+/* Minimal timing helpers shared by the micro-benchmarks in this directory.
+ *
+ * The benchmarks are standalone programs and not part of MyBot.vcxproj. Build
+ * one together with the sources it measures, with optimizations on, e.g. from
+ * the MyBot directory:
+ *
+ *   g++ -std=c++17 -O2 -DFMT_HEADER_ONLY -Idependencies/include/dpp-9.0 bench/snowflake_bench.cpp src/snowflake.cpp
+ *   cl /std:c++17 /O2 /EHsc /Idependencies\include\dpp-9.0 bench\snowflake_bench.cpp src\snowflake.cpp
+ *
+ * Each prints the best of several runs, which is the least noisy figure on a
+ * shared machine.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+namespace bench {
+
+    inline volatile uint64_t sink;
+
+    /** Stops the optimizer from discarding a result, by storing it to a volatile */
+    template <typename T> inline void keep( T value ) {
+        sink = static_cast<uint64_t>( value );
+    }
+
+    /**
+     * @brief Best time per iteration of fn over several runs, in nanoseconds
+     *
+     * @param iterations Calls per run
+     * @param fn Called with the iteration index
+     */
+    template <typename F> double ns_per_op( size_t iterations, F fn, int runs = 5 ) {
+        double best = 1e300;
+        for ( int r = 0; r < runs; ++r ) {
+            auto start = std::chrono::steady_clock::now();
+            for ( size_t i = 0; i < iterations; ++i ) {
+                fn( i );
+            }
+            std::chrono::duration<double, std::nano> took = std::chrono::steady_clock::now() - start;
+            best = std::min( best, took.count() / iterations );
+        }
+        return best;
+    }
+
+    inline void report( const char *name, double ns ) {
+        std::printf( "  %-28s %10.1f ns\n", name, ns );
+    }
+
+    /** Throughput for a run over bytes, from a time per pass */
+    inline void report_rate( const char *name, double ns_per_pass, size_t bytes ) {
+        std::printf( "  %-28s %10.2f GB/s\n", name, bytes / ns_per_pass );
+    }
+
+} // namespace bench
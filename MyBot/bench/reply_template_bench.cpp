@@ -0,0 +1,68 @@
+/* The select menu reply rendered with reply_template, with concatenation and with fmt directly.
+ * See bench.h for building; add src/reply_template.cpp. Counts allocations through a replaced operator new. */
+#include "bench.h"
+#include "../src/reply_template.h"
+#include <atomic>
+#include <cstdlib>
+#include <iterator>
+#include <new>
+#include <string>
+
+namespace {
+    std::atomic<size_t> allocations{ 0 };
+} // namespace
+
+void *operator new( size_t size ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void *p = std::malloc( size ? size : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void *p ) noexcept {
+    std::free( p );
+}
+
+void operator delete( void *p, size_t ) noexcept {
+    std::free( p );
+}
+
+int main() {
+    const mybot::reply_template select_reply( "You clicked {id} and chose: {choice}", { "id", "choice" } );
+    const std::string custom_id = "select_menu_with_a_fairly_long_custom_id";
+    const std::string choice = "the third option, which has a long label";
+    const size_t iterations = 2000000;
+    const int runs = 5;
+
+    std::printf( "%zu renders of the select menu reply, per reply:\n", iterations );
+
+    size_t before = allocations;
+    double ns = bench::ns_per_op( iterations, [&]( size_t ) {
+        thread_local std::string buffer;
+        bench::keep( select_reply.render( buffer, custom_id, choice ).size() );
+    }, runs );
+    bench::report( "reply_template", ns );
+    std::printf( "  %-28s %10zu allocations in total\n", "", allocations - before );
+
+    /* The old handler: concatenate, then dpp::message copies the content into itself */
+    before = allocations;
+    ns = bench::ns_per_op( iterations, [&]( size_t ) {
+        std::string content = "You clicked " + custom_id + " and chose: " + choice;
+        std::string message_content( content );
+        bench::keep( message_content.size() );
+    }, runs );
+    bench::report( "concatenation + copy", ns );
+    std::printf( "  %-28s %10.1f allocations per reply\n", "", double( allocations - before ) / ( iterations * runs ) );
+
+    before = allocations;
+    ns = bench::ns_per_op( iterations, [&]( size_t ) {
+        thread_local std::string buffer;
+        buffer.clear();
+        fmt::format_to( std::back_inserter( buffer ), FMT_COMPILE( "You clicked {} and chose: {}" ), custom_id, choice );
+        bench::keep( buffer.size() );
+    }, runs );
+    bench::report( "fmt::format_to + FMT_COMPILE", ns );
+    std::printf( "  %-28s %10zu allocations in total\n", "", allocations - before );
+    return 0;
+}
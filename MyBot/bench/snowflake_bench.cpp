@@ -0,0 +1,32 @@
+/* parse_snowflake against std::stoull and std::from_chars on 1M random 18-digit ids. See bench.h for building. */
+#include "bench.h"
+#include "../src/snowflake.h"
+#include <charconv>
+#include <random>
+#include <string>
+#include <vector>
+
+int main() {
+    std::mt19937_64 random( 42 );
+    std::uniform_int_distribution<uint64_t> ids( 100000000000000000ull, 999999999999999999ull );
+    std::vector<std::string> input( 1 << 20 );
+    for ( auto &s : input ) {
+        s = std::to_string( ids( random ) );
+    }
+    const size_t mask = input.size() - 1;
+
+    std::printf( "Parsing %zu random 18-digit ids, per id:\n", input.size() );
+    bench::report( "std::stoull", bench::ns_per_op( input.size(), [&]( size_t i ) {
+                       bench::keep( std::stoull( input[i & mask] ) );
+                   } ) );
+    bench::report( "std::from_chars", bench::ns_per_op( input.size(), [&]( size_t i ) {
+                       const std::string &s = input[i & mask];
+                       uint64_t v = 0;
+                       std::from_chars( s.data(), s.data() + s.size(), v );
+                       bench::keep( v );
+                   } ) );
+    bench::report( "mybot::to_snowflake", bench::ns_per_op( input.size(), [&]( size_t i ) {
+                       bench::keep( mybot::to_snowflake( input[i & mask] ) );
+                   } ) );
+    return 0;
+}
@@ -0,0 +1,77 @@
+/* parse_iso8601 against the C library route, plus a format/parse round trip checked against gmtime.
+ * See bench.h for building; add src/timestamp.cpp. */
+#include "bench.h"
+#include "../src/timestamp.h"
+#include <cstring>
+#include <ctime>
+#include <random>
+#include <string>
+#include <vector>
+#ifdef _WIN32
+#include <iomanip>
+#include <sstream>
+#endif
+
+namespace {
+    /* What the bot did before: strptime for the fields, timegm for the epoch (std::get_time and _mkgmtime on Windows) */
+    time_t libc_parse( const std::string &s ) {
+        std::tm tm{};
+#ifdef _WIN32
+        std::istringstream in( s );
+        in >> std::get_time( &tm, "%Y-%m-%dT%H:%M:%S" );
+        return _mkgmtime( &tm );
+#else
+        strptime( s.c_str(), "%Y-%m-%dT%H:%M:%S", &tm );
+        return timegm( &tm );
+#endif
+    }
+
+    bool utc_fields( time_t t, std::tm &tm ) {
+#ifdef _WIN32
+        return gmtime_s( &tm, &t ) == 0;
+#else
+        return gmtime_r( &t, &tm ) != nullptr;
+#endif
+    }
+} // namespace
+
+int main() {
+    std::mt19937_64 random( 42 );
+
+    /* Round trip: format, parse back, and compare the fields with gmtime's */
+    std::uniform_int_distribution<int64_t> instants( 0, 4102444800000ll ); /* up to 2100-01-01 */
+    size_t mismatches = 0;
+    for ( int i = 0; i < 1000000; ++i ) {
+        int64_t ms = instants( random );
+        char text[mybot::iso8601_length];
+        int64_t back = 0;
+        std::tm tm{};
+        if ( !mybot::parse_iso8601( mybot::format_iso8601( ms, text ), back ) || back != ms || !utc_fields( static_cast<time_t>( ms / 1000 ), tm ) ) {
+            ++mismatches;
+            continue;
+        }
+        char expected[32];
+        std::strftime( expected, sizeof( expected ), "%Y-%m-%dT%H:%M:%S", &tm );
+        mismatches += std::memcmp( expected, text, 19 ) != 0;
+    }
+    std::printf( "Round trip of 1000000 instants against gmtime: %zu mismatches\n", mismatches );
+
+    /* Member-chunk style timestamps, microsecond fraction and explicit offset */
+    std::vector<std::string> input( 200000 );
+    for ( auto &s : input ) {
+        char text[mybot::iso8601_length];
+        s.assign( mybot::format_iso8601( instants( random ), text ).substr( 0, 23 ) );
+        s += "000+00:00";
+    }
+
+    std::printf( "Parsing %zu timestamps like \"%s\", per timestamp:\n", input.size(), input[0].c_str() );
+    bench::report( "strptime + timegm", bench::ns_per_op( input.size(), [&]( size_t i ) {
+                       bench::keep( libc_parse( input[i] ) );
+                   } ) );
+    bench::report( "mybot::parse_iso8601", bench::ns_per_op( input.size(), [&]( size_t i ) {
+                       int64_t ms = 0;
+                       mybot::parse_iso8601( input[i], ms );
+                       bench::keep( ms );
+                   } ) );
+    return mismatches ? 1 : 0;
+}
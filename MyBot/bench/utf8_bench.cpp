@@ -0,0 +1,105 @@
+/* The utf8.h scanners against byte-at-a-time versions, on 1 MiB of mixed CJK and ASCII text.
+ * See bench.h for building; add src/utf8.cpp. */
+#include "bench.h"
+#include "../src/utf8.h"
+#include <algorithm>
+#include <random>
+#include <string>
+
+namespace {
+    /* Step over one code point at a time by its lead byte, the way dpp::utility::utf8len does */
+    size_t step( unsigned char b ) {
+        return b < 0x80 ? 1 : b < 0xe0 ? 2 : b < 0xf0 ? 3 : 4;
+    }
+
+    size_t scalar_length( std::string_view s ) {
+        size_t count = 0;
+        for ( size_t i = 0; i < s.size(); i += step( static_cast<unsigned char>( s[i] ) ) ) {
+            ++count;
+        }
+        return count;
+    }
+
+    size_t scalar_advance( std::string_view s, size_t n ) {
+        size_t i = 0;
+        for ( ; i < s.size() && n; --n ) {
+            i += step( static_cast<unsigned char>( s[i] ) );
+        }
+        return std::min( i, s.size() );
+    }
+
+    /* The same checks as utf8_valid, without skipping ASCII runs in blocks */
+    bool scalar_valid( std::string_view s ) {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>( s.data() );
+        for ( size_t i = 0, n = s.size(); i < n; ) {
+            unsigned char b = p[i];
+            if ( b < 0x80 ) {
+                ++i;
+                continue;
+            }
+            size_t need = b < 0xc2 ? 0 : b < 0xe0 ? 1 : b < 0xf0 ? 2 : b < 0xf5 ? 3 : 0;
+            unsigned char lo = b == 0xe0 ? 0xa0 : b == 0xf0 ? 0x90 : 0x80;
+            unsigned char hi = b == 0xed ? 0x9f : b == 0xf4 ? 0x8f : 0xbf;
+            if ( !need || n - i <= need || p[i + 1] < lo || p[i + 1] > hi ) {
+                return false;
+            }
+            for ( size_t k = 2; k <= need; ++k ) {
+                if ( ( p[i + k] & 0xc0 ) != 0x80 ) {
+                    return false;
+                }
+            }
+            i += need + 1;
+        }
+        return true;
+    }
+} // namespace
+
+int main() {
+    /* Runs of ASCII words between runs of CJK ideographs, as in a bilingual channel */
+    std::mt19937 random( 42 );
+    std::string text;
+    while ( text.size() < ( 1u << 20 ) - 64 ) {
+        for ( int w = random() % 8; w >= 0; --w ) {
+            text.append( "word ", 1 + random() % 5 );
+        }
+        for ( int c = random() % 12; c >= 0; --c ) {
+            char32_t cp = 0x4e00 + random() % 0x5000;
+            text += static_cast<char>( 0xe0 | ( cp >> 12 ) );
+            text += static_cast<char>( 0x80 | ( ( cp >> 6 ) & 0x3f ) );
+            text += static_cast<char>( 0x80 | ( cp & 0x3f ) );
+        }
+    }
+    const size_t code_points = mybot::utf8_length( text );
+    if ( code_points != scalar_length( text ) || mybot::utf8_advance( text, code_points / 2 ) != scalar_advance( text, code_points / 2 ) || !mybot::utf8_valid( text ) || !scalar_valid( text ) ) {
+        std::printf( "Scalar and vectorised results differ\n" );
+        return 1;
+    }
+
+    std::printf( "%zu bytes, %zu code points:\n", text.size(), code_points );
+    const size_t passes = 50;
+    bench::report_rate( "scalar length", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( scalar_length( text ) );
+                        } ),
+        text.size() );
+    bench::report_rate( "mybot::utf8_length", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( mybot::utf8_length( text ) );
+                        } ),
+        text.size() );
+    bench::report_rate( "scalar advance", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( scalar_advance( text, code_points ) );
+                        } ),
+        text.size() );
+    bench::report_rate( "mybot::utf8_advance", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( mybot::utf8_advance( text, code_points ) );
+                        } ),
+        text.size() );
+    bench::report_rate( "scalar valid", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( scalar_valid( text ) );
+                        } ),
+        text.size() );
+    bench::report_rate( "mybot::utf8_valid", bench::ns_per_op( passes, [&]( size_t ) {
+                            bench::keep( mybot::utf8_valid( text ) );
+                        } ),
+        text.size() );
+    return 0;
+}
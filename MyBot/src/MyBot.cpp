@@ -2,8 +2,24 @@
 #include <dpp/fmt/format.h>
 #include <dpp/message.h>
 #include <dpp/nlohmann/json.hpp>
+#include <charconv>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include "ascii.h"
+#include "builders.h"
+#include "component_router.h"
+#include "component_state.h"
+#include "gateway_monitor.h"
+#include "guild_ready_tracker.h"
+#include "message_cache.h"
+#include "metrics.h"
+#include "payload.h"
+#include "purge.h"
+#include "reaction_aggregator.h"
+#include "reply_template.h"
+#include "sanitize.h"
+#include "snowflake.h"
 using json = nlohmann::json;
 
 int main() {
@@ -18,48 +34,268 @@ int main() {
     /* Specifying a prefix of "/" tells the command handler it should also expect slash commands */
     command_handler.add_prefix( "." ).add_prefix( "/" );
 
+    /* Shard, cache and REST statistics, served as Prometheus text if "metrics_port" is configured */
+    mybot::metrics stats( bot );
+
+    /* Recent messages in the channels listed under "message_cache", kept so edits and deletes can be logged */
+    std::unique_ptr<mybot::message_cache> recent;
+    if ( configdocument.contains( "message_cache" ) ) {
+        const json &settings = configdocument["message_cache"];
+        recent = std::make_unique<mybot::message_cache>( settings.value( "per_channel", size_t{ 50 } ), settings.value( "max_bytes", size_t{ 4 } << 20 ) );
+        for ( const std::string &id : settings.value( "channels", std::vector<std::string>() ) ) {
+            recent->watch( mybot::to_snowflake( id ) );
+        }
+        stats.add_collector( [&recent]( std::string &out ) {
+            recent->render( out );
+        } );
+    }
+
+    if ( configdocument.contains( "metrics_port" ) ) {
+        uint16_t port = configdocument["metrics_port"];
+        if ( !stats.listen( port ) ) {
+            std::cout << "Could not start metrics endpoint on port " << port << '\n';
+        }
+    }
+
+    /* Serializes outgoing messages straight into a reusable buffer instead of building a json tree */
+    mybot::payload_sender sender( bot );
+
+    /* Runs "!purge" requests in the background, batching deletes and pacing them to the channel's rate limit */
+    mybot::purger purges( bot );
+
+    /* Track heartbeat round trips and flag shards that stop receiving ACKs */
+    mybot::gateway_monitor monitor( stats );
+
+    /* Report how long each shard takes from READY until all of its guilds are available */
+    mybot::guild_ready_tracker ready_tracker( bot );
+
+    /* Signs state packed into component custom_ids. Without a configured "component_secret"
+     * a random one is used, and buttons sent before a restart stop working after it. */
+    std::string component_secret;
+    if ( configdocument.contains( "component_secret" ) ) {
+        component_secret = configdocument["component_secret"];
+    }
+    else {
+        std::random_device random;
+        for ( int i = 0; i < 32; ++i ) {
+            component_secret += static_cast<char>( random() );
+        }
+    }
+    const mybot::hmac_sha256 component_key( component_secret );
+
+    /* A click counter whose owner and count live in the button's custom_id rather than in a map.
+     * The count is a 16-bit field, so it stops at 65535 instead of wrapping to 0. */
+    constexpr unsigned click_bits = 16;
+    constexpr uint64_t max_clicks = ( uint64_t( 1 ) << click_bits ) - 1;
+    auto counter_message = [&component_key]( dpp::snowflake channel_id, dpp::snowflake owner, uint64_t clicks ) {
+        std::string id = "count:";
+        mybot::state_writer().put_id( owner ).put( clicks, click_bits ).append_to( id, &component_key );
+        dpp::component button;
+        button.set_label( fmt::format( "Clicked {} times", clicks ) ).set_type( dpp::cot_button ).set_style( dpp::cos_primary ).set_id( id );
+        dpp::component row;
+        mybot::add_component( row, std::move( button ) );
+        dpp::message m( channel_id, "Only the person who asked for this counter can click it" );
+        mybot::add_component( m, std::move( row ) );
+        return m;
+    };
+
+    bot.on_guild_create( [&ready_tracker, &stats]( const dpp::guild_create_t &event ) {
+        stats.count_event( event );
+        ready_tracker.on_guild_create( event );
+    } );
+
     /* Message handler to look for a command called !button */
-    bot.on_message_create( [&bot]( const dpp::message_create_t &event ) {
-        if ( event.msg->content == "!button" ) {
-            /* Create a message containing an action row, and a button within the action row. */
-            bot.message_create(
-                dpp::message( event.msg->channel_id, "this text has buttons" ).add_component( dpp::component().add_component( dpp::component().set_label( "你他媽再點" ).set_type( dpp::cot_button ).set_emoji( "😄" ).set_style( dpp::cos_danger ).set_id( "何宜謙好強==" ) ) ) );
+    bot.on_message_create( [&counter_message, &purges, &recent, &sender, &stats]( const dpp::message_create_t &event ) {
+        stats.count_event( event );
+        if ( recent ) {
+            recent->insert( *event.msg );
         }
-        else if ( event.msg->content == "!test" ) {
-            bot.message_create( dpp::message( event.msg->channel_id, "Success!" ) );
+        if ( mybot::iequals( event.msg->content, "!button" ) ) {
+            /* Create a message containing an action row, and a button within the action row.
+             * Each part is moved into its parent rather than copied. */
+            dpp::component button;
+            button.set_label( "你他媽再點" ).set_type( dpp::cot_button ).set_emoji( "😄" ).set_style( dpp::cos_danger ).set_id( "何宜謙好強==" );
+            dpp::component row;
+            mybot::add_component( row, std::move( button ) );
+            dpp::message m( event.msg->channel_id, "this text has buttons" );
+            mybot::add_component( m, std::move( row ) );
+            sender.message_create( m, stats.timed() );
         }
-        else if ( event.msg->content == "!terry" ) {
-            bot.message_create( dpp::message( event.msg->channel_id, "何宜謙好電......" ) );
+        else if ( mybot::iequals( event.msg->content, "!test" ) ) {
+            sender.message_create( dpp::message( event.msg->channel_id, "Success!" ), stats.timed() );
         }
-        else if ( event.msg->content == "!select" ) {
+        else if ( mybot::iequals( event.msg->content, "!terry" ) ) {
+            sender.message_create( dpp::message( event.msg->channel_id, "何宜謙好電......" ), stats.timed() );
+        }
+        else if ( mybot::iequals( event.msg->content, "!counter" ) ) {
+            sender.message_create( counter_message( event.msg->channel_id, event.msg->author->id, 0 ), stats.timed() );
+        }
+        else if ( mybot::iequals( event.msg->content, "!select" ) ) {
             /* Create a message containing an action row, and a select menu within the action row. */
+            dpp::component menu;
+            menu.set_type( dpp::cot_selectmenu ).set_placeholder( "Pick something" ).set_id( "myselid" );
+            mybot::add_select_option( menu, std::move( dpp::select_option( "label1", "value1", "description1" ).set_emoji( "😄" ) ) );
+            mybot::add_select_option( menu, std::move( dpp::select_option( "label2", "value2", "description2" ).set_emoji( "🙂" ) ) );
+            dpp::component row;
+            mybot::add_component( row, std::move( menu ) );
             dpp::message m( event.msg->channel_id, "this text has a select menu" );
-            m.add_component(
-                dpp::component().add_component(
-                    dpp::component().set_type( dpp::cot_selectmenu ).set_placeholder( "Pick something" ).add_select_option( dpp::select_option( "label1", "value1", "description1" ).set_emoji( "😄" ) ).add_select_option( dpp::select_option( "label2", "value2", "description2" ).set_emoji( "🙂" ) ).set_id( "myselid" ) ) );
-            bot.message_create( m );
+            mybot::add_component( m, std::move( row ) );
+            sender.message_create( m, stats.timed() );
+        }
+        else if ( mybot::istarts_with( event.msg->content, "!purge " ) ) {
+            /* "!purge N" deletes the N messages before the command, "!purge stop" cancels a running purge */
+            const dpp::snowflake channel_id = event.msg->channel_id;
+            dpp::channel *c = stats.find_channel( channel_id );
+            if ( !c || !( c->get_user_permissions( event.msg->author ) & ( dpp::p_manage_messages | dpp::p_administrator ) ) ) {
+                return;
+            }
+            std::string_view arg = std::string_view( event.msg->content ).substr( 7 );
+            if ( mybot::iequals( arg, "stop" ) ) {
+                purges.cancel( channel_id );
+                return;
+            }
+            size_t count = 0;
+            auto parsed = std::from_chars( arg.data(), arg.data() + arg.size(), count );
+            if ( parsed.ec != std::errc() || parsed.ptr != arg.data() + arg.size() || count == 0 ) {
+                sender.message_create( dpp::message( channel_id, "Usage: !purge <count> or !purge stop" ), stats.timed() );
+                return;
+            }
+            mybot::purge_request request;
+            request.channel_id = channel_id;
+            request.before = event.msg->id;
+            request.limit = request.scan_limit = std::min<size_t>( count, 1000 );
+            request.progress = [&sender, &stats, channel_id]( const mybot::purge_progress &p ) {
+                if ( !p.done ) {
+                    std::cout << fmt::format( "Purge in {}: {} of {} deleted\n", channel_id, p.deleted, p.matched );
+                    return;
+                }
+                std::string result = fmt::format( "Purged {} messages", p.deleted );
+                if ( p.failed ) {
+                    result += fmt::format( ", {} could not be deleted", p.failed );
+                }
+                if ( p.cancelled ) {
+                    result += " before being stopped";
+                }
+                sender.message_create( dpp::message( channel_id, result ), stats.timed() );
+            };
+            if ( !purges.start( std::move( request ) ) ) {
+                sender.message_create( dpp::message( channel_id, "A purge is already running in this channel" ), stats.timed() );
+            }
+        }
+    } );
+
+    bot.on_message_update( [&recent, &stats]( const dpp::message_update_t &event ) {
+        stats.count_event( event );
+        /* Embed unfurls also arrive as updates, without a content field. Look at d.content itself:
+         * a substring search would also find referenced_message.content on replies. */
+        if ( !recent ) {
+            return;
+        }
+        json raw = json::parse( event.raw_event, nullptr, false );
+        if ( raw.is_discarded() || !raw.contains( "d" ) || !raw["d"].contains( "content" ) ) {
+            return;
+        }
+        mybot::cached_message before;
+        if ( recent->update( *event.updated, &before ) && before.content != event.updated->content ) {
+            std::cout << fmt::format( "Message {} in {} edited by {}:\n- {}\n+ {}\n", before.id, event.updated->channel_id, before.author_id, before.content, event.updated->content );
+        }
+    } );
+
+    bot.on_message_delete( [&recent, &stats]( const dpp::message_delete_t &event ) {
+        stats.count_event( event );
+        mybot::cached_message removed;
+        if ( recent && recent->erase( event.deleted->channel_id, event.deleted->id, &removed ) ) {
+            std::cout << fmt::format( "Message {} in {} by {} deleted: {}\n", removed.id, event.deleted->channel_id, removed.author_id, removed.content );
+        }
+    } );
+
+    /* Reaction clicks are coalesced per message and emoji and logged once a second */
+    mybot::reaction_aggregator reactions( []( const std::vector<mybot::reaction_delta> &deltas ) {
+        for ( const auto &d : deltas ) {
+            std::cout << fmt::format( "Reactions on {} in {} {}: +{} -{} = {}\n", d.message_id, d.channel_id, d.emoji_id ? fmt::format( "<:{}:{}>", d.emoji_name, d.emoji_id ) : d.emoji_name, d.added, d.removed, d.total );
+        }
+    } );
+
+    bot.on_message_reaction_add( [&reactions, &stats]( const dpp::message_reaction_add_t &event ) {
+        stats.count_event( event );
+        reactions.on_reaction_add( event );
+    } );
+
+    bot.on_message_reaction_remove( [&reactions, &stats]( const dpp::message_reaction_remove_t &event ) {
+        stats.count_event( event );
+        reactions.on_reaction_remove( event );
+    } );
+
+    bot.on_message_reaction_remove_emoji( [&reactions, &stats]( const dpp::message_reaction_remove_emoji_t &event ) {
+        stats.count_event( event );
+        reactions.on_reaction_remove_emoji( event );
+    } );
+
+    bot.on_message_reaction_remove_all( [&reactions, &stats]( const dpp::message_reaction_remove_all_t &event ) {
+        stats.count_event( event );
+        reactions.on_reaction_remove_all( event );
+    } );
+
+    /* Events missed while disconnected are not replayed, so re-read the counts being tracked */
+    bot.on_resumed( [&bot, &reactions, &stats]( const dpp::resumed_t &event ) {
+        stats.count_event( event );
+        reactions.reconcile( bot );
+    } );
+
+    /* Component handlers are registered per custom_id pattern; see mybot::route_table for the syntax */
+    mybot::component_router<dpp::button_click_t> buttons;
+    mybot::component_router<dpp::select_click_t> selects;
+
+    /* Reply templates are parsed once here and rendered into a per-thread buffer */
+    const mybot::reply_template select_reply( "You clicked {id} and chose: {choice}", { "id", "choice" } );
+
+    selects.add( "myselid", [&sender, &stats, &select_reply]( const dpp::select_click_t &event, const mybot::route_params & ) {
+        thread_local std::string content;
+        sender.interaction_reply( event, dpp::ir_channel_message_with_source, select_reply.render( content, event.custom_id, event.values[0] ), stats.timed() );
+    } );
+
+    buttons.add( "count:{state}", [&component_key, &counter_message, &sender, &stats]( const dpp::button_click_t &event, const mybot::route_params &params ) {
+        mybot::state_reader state( event.custom_id, params.get( "state" ), &component_key );
+        dpp::snowflake owner = state.get_id();
+        uint64_t clicks = state.get( click_bits );
+        dpp::snowflake clicker = event.command.usr.id ? event.command.usr.id : event.command.member.user_id;
+        if ( !state.ok() ) {
+            sender.interaction_reply( event, dpp::ir_channel_message_with_source, std::string_view( "This button has expired" ), stats.timed() );
+        }
+        else if ( clicker != owner ) {
+            sender.interaction_reply( event, dpp::ir_channel_message_with_source, std::string_view( "This is not your counter" ), stats.timed() );
+        }
+        else {
+            sender.interaction_reply( event, dpp::ir_update_message, counter_message( event.command.channel_id, owner, clicks < max_clicks ? clicks + 1 : clicks ), stats.timed() );
         }
     } );
 
     /* When a user clicks your button, the on_button_click event will fire,
      * containing the custom_id you defined in your button.
      */
-    bot.on_button_click( [&bot]( const dpp::button_click_t &event ) {
+    bot.on_button_click( [&buttons, &sender, &stats]( const dpp::button_click_t &event ) {
+        stats.count_event( event );
         /* Button clicks are still interactions, and must be replied to in some form to
          * prevent the "this interaction has failed" message from Discord to the user.
          */
-        event.reply( dpp::ir_channel_message_with_source, event.custom_id );
+        if ( !buttons.dispatch( event ) ) {
+            sender.interaction_reply( event, dpp::ir_channel_message_with_source, std::string_view( event.custom_id ), stats.timed() );
+        }
     } );
 
-    bot.on_select_click( [&bot]( const dpp::select_click_t &event ) {
-        /* Select clicks are still interactions, and must be replied to in some form to
-         * prevent the "this interaction has failed" message from Discord to the user.
-         */
-        event.reply( dpp::ir_channel_message_with_source, "You clicked " + event.custom_id + " and chose: " + event.values[0] );
+    bot.on_select_click( [&selects, &sender, &stats]( const dpp::select_click_t &event ) {
+        stats.count_event( event );
+        if ( !selects.dispatch( event ) ) {
+            sender.interaction_reply( event, dpp::ir_channel_message_with_source, std::string_view( event.custom_id ), stats.timed() );
+        }
     } );
 
-    bot.on_ready( [&bot, &command_handler]( const dpp::ready_t &event ) {
+    bot.on_ready( [&bot, &command_handler, &ready_tracker, &stats, &monitor, &reactions]( const dpp::ready_t &event ) {
         std::cout << "Logged in as " << bot.me.username << '\n';
+        stats.count_event( event );
+        ready_tracker.on_ready( event );
+        monitor.start();
+        reactions.start();
 
         command_handler.add_command(
             /* Command name */
@@ -70,12 +306,18 @@ int main() {
                 { "testparameter", dpp::param_info( dpp::pt_string, true, "Optional test parameter" ) } },
 
             /* Command handler */
-            [&command_handler]( const std::string &command, const dpp::parameter_list_t &parameters, dpp::command_source src ) {
-                std::string got_param;
+            [&bot, &command_handler, &monitor]( const std::string &command, const dpp::parameter_list_t &parameters, dpp::command_source src ) {
+                /* The parameter is echoed back, so escape markdown and break any pings in it */
+                static thread_local std::string got_param;
+                got_param.clear();
                 if ( !parameters.empty() ) {
-                    got_param = std::get<std::string>( parameters[0].second );
+                    mybot::sanitize( std::get<std::string>( parameters[0].second ), got_param );
                 }
-                command_handler.reply( dpp::message( "Pong! -> " + got_param ), src );
+                dpp::message pong( fmt::format( "Pong! -> {} (REST {:.0f} ms, gateway {:.0f} ms)", got_param, bot.rest_ping * 1000, monitor.gateway_ping() * 1000 ) );
+                /* Parse no mentions at all, so nothing the sanitizer misses can ping. D++ only sends
+                 * allowed_mentions when some field is set, hence replied_user, which pings nobody else. */
+                pong.set_allowed_mentions( false, false, false, true, {}, {} );
+                command_handler.reply( pong, src );
             },
 
             /* Command description */
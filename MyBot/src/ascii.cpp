@@ -0,0 +1,153 @@
+#include "ascii.h"
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #include <emmintrin.h>
+    #define MYBOT_ASCII_SSE2
+#endif
+
+namespace mybot {
+
+    namespace {
+        constexpr uint64_t ones = 0x0101010101010101ull;
+        constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+        /* 0x20 in every byte of x that lies in [lo, hi]; bytes >= 0x80 never match */
+        inline uint64_t case_bits( uint64_t x, unsigned char lo, unsigned char hi ) {
+            uint64_t heptets = x & ~high_bits;
+            uint64_t ge_lo = heptets + ( 0x80 - lo ) * ones;
+            uint64_t gt_hi = heptets + ( 0x80 - hi - 1 ) * ones;
+            return ( ( ge_lo ^ gt_hi ) & ~x & high_bits ) >> 2;
+        }
+
+        inline uint64_t lower8( uint64_t x ) {
+            return x | case_bits( x, 'A', 'Z' );
+        }
+
+        inline uint64_t upper8( uint64_t x ) {
+            return x ^ case_bits( x, 'a', 'z' );
+        }
+
+        inline uint64_t load8( const char *p ) {
+            uint64_t v;
+            std::memcpy( &v, p, sizeof( v ) );
+            return v;
+        }
+
+        inline char lower1( char c ) {
+            return ( c >= 'A' && c <= 'Z' ) ? static_cast<char>( c | 0x20 ) : c;
+        }
+
+        inline char upper1( char c ) {
+            return ( c >= 'a' && c <= 'z' ) ? static_cast<char>( c & ~0x20 ) : c;
+        }
+
+        template <bool Lower> void fold( char *p, size_t n ) {
+            size_t i = 0;
+#ifdef MYBOT_ASCII_SSE2
+            const __m128i lo = _mm_set1_epi8( Lower ? 'A' - 1 : 'a' - 1 );
+            const __m128i hi = _mm_set1_epi8( Lower ? 'Z' + 1 : 'z' + 1 );
+            const __m128i bit = _mm_set1_epi8( 0x20 );
+            for ( ; i + 16 <= n; i += 16 ) {
+                __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( p + i ) );
+                /* Signed compares: bytes >= 0x80 are negative and never fall inside the range */
+                __m128i in_range = _mm_and_si128( _mm_cmpgt_epi8( v, lo ), _mm_cmplt_epi8( v, hi ) );
+                v = _mm_xor_si128( v, _mm_and_si128( in_range, bit ) );
+                _mm_storeu_si128( reinterpret_cast<__m128i *>( p + i ), v );
+            }
+#endif
+            for ( ; i + 8 <= n; i += 8 ) {
+                uint64_t v = Lower ? lower8( load8( p + i ) ) : upper8( load8( p + i ) );
+                std::memcpy( p + i, &v, sizeof( v ) );
+            }
+            for ( ; i < n; ++i ) {
+                p[i] = Lower ? lower1( p[i] ) : upper1( p[i] );
+            }
+        }
+    } // namespace
+
+    void ascii_lower( std::string &s ) {
+        fold<true>( s.data(), s.size() );
+    }
+
+    void ascii_upper( std::string &s ) {
+        fold<false>( s.data(), s.size() );
+    }
+
+    std::string to_ascii_lower( std::string_view s ) {
+        std::string r( s );
+        ascii_lower( r );
+        return r;
+    }
+
+    std::string to_ascii_upper( std::string_view s ) {
+        std::string r( s );
+        ascii_upper( r );
+        return r;
+    }
+
+    bool iequals( std::string_view a, std::string_view b ) {
+        if ( a.size() != b.size() ) {
+            return false;
+        }
+        size_t i = 0;
+        for ( ; i + 8 <= a.size(); i += 8 ) {
+            if ( lower8( load8( a.data() + i ) ) != lower8( load8( b.data() + i ) ) ) {
+                return false;
+            }
+        }
+        for ( ; i < a.size(); ++i ) {
+            if ( lower1( a[i] ) != lower1( b[i] ) ) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    int icompare( std::string_view a, std::string_view b ) {
+        size_t n = a.size() < b.size() ? a.size() : b.size();
+        size_t i = 0;
+        /* Skip equal words quickly, then find the exact differing byte */
+        while ( i + 8 <= n && lower8( load8( a.data() + i ) ) == lower8( load8( b.data() + i ) ) ) {
+            i += 8;
+        }
+        for ( ; i < n; ++i ) {
+            unsigned char ca = static_cast<unsigned char>( lower1( a[i] ) );
+            unsigned char cb = static_cast<unsigned char>( lower1( b[i] ) );
+            if ( ca != cb ) {
+                return ca < cb ? -1 : 1;
+            }
+        }
+        return a.size() == b.size() ? 0 : ( a.size() < b.size() ? -1 : 1 );
+    }
+
+    bool istarts_with( std::string_view s, std::string_view prefix ) {
+        return s.size() >= prefix.size() && iequals( s.substr( 0, prefix.size() ), prefix );
+    }
+
+    std::string format_thousands( int64_t value, char separator ) {
+        char digits[24];
+        auto r = std::to_chars( digits, digits + sizeof( digits ), value );
+        const char *p = digits;
+        bool negative = *p == '-';
+        if ( negative ) {
+            ++p;
+        }
+        size_t n = static_cast<size_t>( r.ptr - p );
+
+        std::string out;
+        out.reserve( n + n / 3 + 1 );
+        if ( negative ) {
+            out += '-';
+        }
+        /* The first group holds 1-3 digits, every later group exactly 3 */
+        size_t first = n % 3 ? n % 3 : 3;
+        out.append( p, first );
+        for ( size_t i = first; i < n; i += 3 ) {
+            out += separator;
+            out.append( p + i, 3 );
+        }
+        return out;
+    }
+
+} // namespace mybot
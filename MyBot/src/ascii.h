@@ -0,0 +1,99 @@
+#pragma once
+#include <charconv>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace mybot {
+
+    /**
+     * @brief Lowercase ASCII letters in place; bytes >= 0x80 (UTF-8) are left alone.
+     * Works 16 bytes at a time with SSE2 where available and 8 at a time otherwise,
+     * with no locale lookups.
+     *
+     * @param s String to fold
+     */
+    void ascii_lower( std::string &s );
+
+    /**
+     * @brief Uppercase ASCII letters in place; bytes >= 0x80 (UTF-8) are left alone.
+     *
+     * @param s String to fold
+     */
+    void ascii_upper( std::string &s );
+
+    /**
+     * @brief Lowercased copy of s
+     */
+    std::string to_ascii_lower( std::string_view s );
+
+    /**
+     * @brief Uppercased copy of s
+     */
+    std::string to_ascii_upper( std::string_view s );
+
+    /**
+     * @brief Compare two strings ignoring ASCII case, e.g. for command names
+     *
+     * @return bool True if a and b are equal after folding
+     */
+    bool iequals( std::string_view a, std::string_view b );
+
+    /**
+     * @brief Three-way comparison ignoring ASCII case
+     *
+     * @return int Negative, zero or positive like std::string_view::compare
+     */
+    int icompare( std::string_view a, std::string_view b );
+
+    /**
+     * @brief True if s starts with prefix, ignoring ASCII case
+     */
+    bool istarts_with( std::string_view s, std::string_view prefix );
+
+    /**
+     * @brief Case-insensitive ordering for std::map/std::set keyed by command name.
+     * Transparent, so lookups can use a std::string_view without building a std::string.
+     */
+    struct iless {
+        using is_transparent = void;
+        bool operator()( std::string_view a, std::string_view b ) const {
+            return icompare( a, b ) < 0;
+        }
+    };
+
+    /**
+     * @brief Format an integer with a thousands separator, e.g. 1234567 -> "1,234,567".
+     * Replaces Comma(), which builds a stringstream and a std::locale("") per call.
+     *
+     * @param value Value to format
+     * @param separator Character placed between groups of three digits
+     * @return std::string Formatted number
+     */
+    std::string format_thousands( int64_t value, char separator = ',' );
+
+    /**
+     * @brief Parse a whole string as a number with std::from_chars.
+     * Replaces from_string(), which goes through an istringstream.
+     *
+     * @tparam T Integer or floating point type
+     * @param s Text to parse; no leading whitespace or '+' is accepted
+     * @param out Receives the value on success
+     * @param base Numeric base for integers, e.g. 10 or 16
+     * @return bool False unless all of s was consumed and the value fits in T
+     */
+    template <typename T> bool parse_number( std::string_view s, T &out, int base = 10 ) {
+        static_assert( std::is_arithmetic_v<T>, "parse_number needs an arithmetic type" );
+        std::from_chars_result r;
+        if constexpr ( std::is_integral_v<T> ) {
+            r = std::from_chars( s.data(), s.data() + s.size(), out, base );
+        }
+        else {
+            r = std::from_chars( s.data(), s.data() + s.size(), out );
+        }
+        return r.ec == std::errc() && r.ptr == s.data() + s.size() && !s.empty();
+    }
+
+} // namespace mybot
@@ -0,0 +1,143 @@
+#include "base64.h"
+#include <array>
+
+namespace mybot {
+
+    namespace {
+        constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+        /* Every 12-bit value mapped to its two output characters */
+        constexpr std::array<std::array<char, 2>, 4096> make_pair_table() {
+            std::array<std::array<char, 2>, 4096> t{};
+            for ( size_t i = 0; i < 4096; ++i ) {
+                t[i][0] = alphabet[i >> 6];
+                t[i][1] = alphabet[i & 63];
+            }
+            return t;
+        }
+
+        /* Character value pre-shifted into position `shift`; bit 24 flags an invalid character */
+        constexpr uint32_t invalid = 1u << 24;
+
+        constexpr std::array<uint32_t, 256> make_decode_table( unsigned shift ) {
+            std::array<uint32_t, 256> t{};
+            for ( auto &v : t ) {
+                v = invalid;
+            }
+            for ( uint32_t i = 0; i < 64; ++i ) {
+                t[static_cast<unsigned char>( alphabet[i] )] = i << shift;
+            }
+            return t;
+        }
+
+        constexpr auto pairs = make_pair_table();
+        constexpr auto d0 = make_decode_table( 18 );
+        constexpr auto d1 = make_decode_table( 12 );
+        constexpr auto d2 = make_decode_table( 6 );
+        constexpr auto d3 = make_decode_table( 0 );
+
+        inline void encode_group( uint32_t v, char *out ) {
+            const auto &hi = pairs[v >> 12];
+            const auto &lo = pairs[v & 0xfff];
+            out[0] = hi[0];
+            out[1] = hi[1];
+            out[2] = lo[0];
+            out[3] = lo[1];
+        }
+
+        inline uint32_t decode_group( const unsigned char *p ) {
+            return d0[p[0]] | d1[p[1]] | d2[p[2]] | d3[p[3]];
+        }
+    } // namespace
+
+    size_t base64_encode( const void *in, size_t n, char *out ) {
+        const unsigned char *p = static_cast<const unsigned char *>( in );
+        char *o = out;
+
+        /* Two groups per iteration keeps both table lookups for each group independent */
+        for ( ; n >= 6; n -= 6, p += 6, o += 8 ) {
+            encode_group( ( uint32_t( p[0] ) << 16 ) | ( uint32_t( p[1] ) << 8 ) | p[2], o );
+            encode_group( ( uint32_t( p[3] ) << 16 ) | ( uint32_t( p[4] ) << 8 ) | p[5], o + 4 );
+        }
+        for ( ; n >= 3; n -= 3, p += 3, o += 4 ) {
+            encode_group( ( uint32_t( p[0] ) << 16 ) | ( uint32_t( p[1] ) << 8 ) | p[2], o );
+        }
+
+        if ( n ) {
+            uint32_t v = uint32_t( p[0] ) << 16;
+            if ( n == 2 ) {
+                v |= uint32_t( p[1] ) << 8;
+            }
+            encode_group( v, o );
+            o[3] = '=';
+            if ( n == 1 ) {
+                o[2] = '=';
+            }
+            o += 4;
+        }
+        return static_cast<size_t>( o - out );
+    }
+
+    void base64_append( std::string &out, const void *in, size_t n ) {
+        size_t start = out.size();
+        out.resize( start + base64_encoded_size( n ) );
+        base64_encode( in, n, &out[start] );
+    }
+
+    bool base64_decode( std::string_view in, void *out, size_t &written ) {
+        size_t n = in.size();
+        if ( n % 4 == 0 && n >= 2 && in[n - 1] == '=' ) {
+            n -= in[n - 2] == '=' ? 2 : 1;
+        }
+        if ( n % 4 == 1 ) {
+            return false;
+        }
+
+        const unsigned char *p = reinterpret_cast<const unsigned char *>( in.data() );
+        unsigned char *o = static_cast<unsigned char *>( out );
+        size_t full = n / 4;
+
+        /* OR the invalid flags together and check once at the end, keeping the loop branch free */
+        uint32_t errors = 0;
+        for ( size_t i = 0; i < full; ++i, p += 4, o += 3 ) {
+            uint32_t v = decode_group( p );
+            errors |= v;
+            o[0] = static_cast<unsigned char>( v >> 16 );
+            o[1] = static_cast<unsigned char>( v >> 8 );
+            o[2] = static_cast<unsigned char>( v );
+        }
+
+        size_t rem = n % 4;
+        if ( rem ) {
+            uint32_t v = d0[p[0]] | d1[p[1]] | ( rem == 3 ? d2[p[2]] : 0 );
+            errors |= v;
+            *o++ = static_cast<unsigned char>( v >> 16 );
+            if ( rem == 3 ) {
+                *o++ = static_cast<unsigned char>( v >> 8 );
+            }
+        }
+
+        if ( errors & invalid ) {
+            return false;
+        }
+        written = static_cast<size_t>( o - static_cast<unsigned char *>( out ) );
+        return true;
+    }
+
+    void load_emoji_image( dpp::emoji &e, std::string_view image_blob, dpp::image_type type ) {
+        static constexpr std::string_view mimetypes[] = { "image/png", "image/jpeg", "image/gif" };
+        if ( image_blob.size() > MAX_EMOJI_SIZE ) {
+            throw dpp::exception( "Emoji file exceeds discord size limit" );
+        }
+
+        std::string *data = new std::string( "data:" );
+        data->reserve( 32 + base64_encoded_size( image_blob.size() ) );
+        data->append( mimetypes[type] );
+        data->append( ";base64," );
+        base64_append( *data, image_blob.data(), image_blob.size() );
+
+        delete e.image_data;
+        e.image_data = data;
+    }
+
+} // namespace mybot
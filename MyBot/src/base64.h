@@ -0,0 +1,68 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief Number of characters base64_encode writes for n input bytes, including padding
+     */
+    constexpr size_t base64_encoded_size( size_t n ) {
+        return ( n + 2 ) / 3 * 4;
+    }
+
+    /**
+     * @brief Upper bound on the bytes base64_decode writes for n input characters
+     */
+    constexpr size_t base64_decoded_max( size_t n ) {
+        return n / 4 * 3 + 3;
+    }
+
+    /**
+     * @brief Encode bytes as standard padded base64 into a caller-provided buffer.
+     *
+     * Three input bytes become four characters through a 4096-entry table that
+     * yields two characters per lookup, six bytes per loop iteration.
+     *
+     * @param in Bytes to encode
+     * @param n Number of bytes, 64-bit sizes are fine
+     * @param out Buffer of at least base64_encoded_size( n ) characters, not NUL terminated
+     * @return size_t Number of characters written
+     */
+    size_t base64_encode( const void *in, size_t n, char *out );
+
+    /**
+     * @brief Append the base64 encoding of in to a string, growing it once
+     *
+     * @param out String to append to
+     * @param in Bytes to encode
+     * @param n Number of bytes
+     */
+    void base64_append( std::string &out, const void *in, size_t n );
+
+    /**
+     * @brief Decode standard base64 into a caller-provided buffer.
+     * Padding is optional; whitespace and URL-safe characters are rejected.
+     *
+     * @param in Characters to decode
+     * @param out Buffer of at least base64_decoded_max( in.size() ) bytes
+     * @param written Receives the number of bytes decoded on success
+     * @return bool False if in contains an invalid character or has an impossible length
+     */
+    bool base64_decode( std::string_view in, void *out, size_t &written );
+
+    /**
+     * @brief Replacement for dpp::emoji::load_image that encodes straight into the
+     * emoji's image data string without the intermediate copies.
+     *
+     * @param e Emoji to attach the image to
+     * @param image_blob Raw image bytes
+     * @param type Image type, used for the data URI prefix
+     * @throws dpp::exception if the image is larger than MAX_EMOJI_SIZE
+     */
+    void load_emoji_image( dpp::emoji &e, std::string_view image_blob, dpp::image_type type );
+
+} // namespace mybot
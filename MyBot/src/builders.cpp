@@ -0,0 +1,94 @@
+#include "builders.h"
+#include "utf8.h"
+#include <utility>
+
+namespace mybot {
+
+    namespace {
+        /* Discord allows five action rows per message and five buttons per row */
+        constexpr size_t max_components = 5;
+        constexpr size_t max_embeds = 10;
+        constexpr size_t max_fields = 25;
+        constexpr size_t field_name_limit = 256;
+        constexpr size_t field_value_limit = 1024;
+
+        void truncate( std::string &s, size_t limit ) {
+            s.resize( utf8_advance( s, limit ) );
+        }
+
+        /* dpp::component and dpp::embed declare destructors, which suppresses their
+         * implicit move constructors, so std::move() alone would still deep copy them.
+         * Move their members across instead. */
+        void steal( dpp::component &to, dpp::component &from ) {
+            to.type = from.type;
+            to.components.swap( from.components );
+            to.label.swap( from.label );
+            to.style = from.style;
+            to.custom_id.swap( from.custom_id );
+            to.url.swap( from.url );
+            to.placeholder.swap( from.placeholder );
+            to.min_values = from.min_values;
+            to.max_values = from.max_values;
+            to.options.swap( from.options );
+            to.disabled = from.disabled;
+            to.emoji.name.swap( from.emoji.name );
+            to.emoji.id = from.emoji.id;
+            to.emoji.animated = from.emoji.animated;
+        }
+
+        void steal( dpp::embed &to, dpp::embed &from ) {
+            to.title.swap( from.title );
+            to.type.swap( from.type );
+            to.description.swap( from.description );
+            to.url.swap( from.url );
+            to.timestamp = from.timestamp;
+            to.color = from.color;
+            to.footer = std::move( from.footer );
+            to.image = std::move( from.image );
+            to.thumbnail = std::move( from.thumbnail );
+            to.video = std::move( from.video );
+            to.provider = std::move( from.provider );
+            to.author = std::move( from.author );
+            to.fields.swap( from.fields );
+        }
+
+        /* Growing a std::vector of components or embeds copies every element, so size it once */
+        template <typename T> void push_reserved( std::vector<T> &v, T &item, size_t limit ) {
+            if ( v.capacity() < limit ) {
+                v.reserve( limit );
+            }
+            steal( v.emplace_back(), item );
+        }
+    } // namespace
+
+    dpp::component &add_component( dpp::component &parent, dpp::component &&child ) {
+        parent.set_type( dpp::cot_action_row );
+        push_reserved( parent.components, child, max_components );
+        return parent;
+    }
+
+    dpp::component &add_select_option( dpp::component &menu, dpp::select_option &&option ) {
+        menu.options.push_back( std::move( option ) );
+        return menu;
+    }
+
+    dpp::message &add_component( dpp::message &m, dpp::component &&row ) {
+        push_reserved( m.components, row, max_components );
+        return m;
+    }
+
+    dpp::message &add_embed( dpp::message &m, dpp::embed &&e ) {
+        push_reserved( m.embeds, e, max_embeds );
+        return m;
+    }
+
+    dpp::embed &add_field( dpp::embed &e, std::string &&name, std::string &&value, bool is_inline ) {
+        if ( e.fields.size() < max_fields ) {
+            truncate( name, field_name_limit );
+            truncate( value, field_value_limit );
+            e.fields.push_back( dpp::embed_field{ std::move( name ), std::move( value ), is_inline } );
+        }
+        return e;
+    }
+
+} // namespace mybot
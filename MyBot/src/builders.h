@@ -0,0 +1,58 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <string>
+
+namespace mybot {
+
+    /**
+     * @brief Move a sub-component into an action row. Same effect as
+     * dpp::component::add_component(), which copies the child's whole tree
+     * (label, id, emoji, select options).
+     *
+     * @param parent Becomes a dpp::cot_action_row
+     * @param child Moved from
+     * @return dpp::component& parent
+     */
+    dpp::component &add_component( dpp::component &parent, dpp::component &&child );
+
+    /**
+     * @brief Move a select option into a select menu, like dpp::component::add_select_option()
+     *
+     * @param menu Select menu
+     * @param option Moved from
+     * @return dpp::component& menu
+     */
+    dpp::component &add_select_option( dpp::component &menu, dpp::select_option &&option );
+
+    /**
+     * @brief Move an action row into a message, like dpp::message::add_component()
+     *
+     * @param m Message
+     * @param row Moved from
+     * @return dpp::message& m
+     */
+    dpp::message &add_component( dpp::message &m, dpp::component &&row );
+
+    /**
+     * @brief Move an embed into a message, like dpp::message::add_embed()
+     *
+     * @param m Message
+     * @param e Moved from
+     * @return dpp::message& m
+     */
+    dpp::message &add_embed( dpp::message &m, dpp::embed &&e );
+
+    /**
+     * @brief Move a field into an embed, like dpp::embed::add_field(). The name and
+     * value are truncated in place to 256 and 1024 characters, and fields past
+     * the 25th are dropped, as D++ does.
+     *
+     * @param e Embed
+     * @param name Moved from
+     * @param value Moved from
+     * @param is_inline Whether the field is displayed inline
+     * @return dpp::embed& e
+     */
+    dpp::embed &add_field( dpp::embed &e, std::string &&name, std::string &&value, bool is_inline = false );
+
+} // namespace mybot
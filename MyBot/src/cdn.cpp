@@ -0,0 +1,75 @@
+#include "cdn.h"
+#include <algorithm>
+#include <charconv>
+
+namespace mybot {
+
+    namespace {
+        constexpr std::string_view cdn_base = "https://cdn.discordapp.com/";
+
+        bool is_empty( const dpp::utility::iconhash &h ) {
+            return h.first == 0 && h.second == 0;
+        }
+    } // namespace
+
+    bool set_iconhash( dpp::utility::iconhash &h, std::string_view s ) {
+        uint64_t first = 0, second = 0;
+        if ( !parse_hash128( s, first, second ) ) {
+            return false;
+        }
+        h.first = first;
+        h.second = second;
+        return true;
+    }
+
+    cdn_url &cdn_url::append( std::string_view s ) {
+        size_t n = std::min( s.size(), capacity - length );
+        std::copy_n( s.data(), n, text + length );
+        length += n;
+        return *this;
+    }
+
+    cdn_url &cdn_url::append( uint64_t v ) {
+        auto result = std::to_chars( text + length, text + capacity, v );
+        length = static_cast<size_t>( result.ptr - text );
+        return *this;
+    }
+
+    cdn_url &cdn_url::append_hash( const dpp::utility::iconhash &h, bool animated ) {
+        if ( animated ) {
+            append( "a_" );
+        }
+        if ( capacity - length >= 32 ) {
+            format_hash128( h.first, h.second, text + length );
+            length += 32;
+        }
+        return append( animated ? ".gif" : ".png" );
+    }
+
+    cdn_url avatar_url( const dpp::user &u, uint16_t size ) {
+        cdn_url url;
+        url.append( cdn_base );
+        if ( is_empty( u.avatar ) ) {
+            url.append( "embed/avatars/" ).append( static_cast<uint64_t>( u.discriminator % 5 ) ).append( ".png" );
+            return url;
+        }
+        url.append( "avatars/" ).append( u.id ).append( "/" ).append_hash( u.avatar, ( u.flags & dpp::u_animated_icon ) != 0 );
+        if ( size ) {
+            url.append( "?size=" ).append( static_cast<uint64_t>( size ) );
+        }
+        return url;
+    }
+
+    cdn_url guild_icon_url( const dpp::guild &g, uint16_t size ) {
+        cdn_url url;
+        if ( is_empty( g.icon ) ) {
+            return url;
+        }
+        url.append( cdn_base ).append( "icons/" ).append( g.id ).append( "/" ).append_hash( g.icon, g.has_animated_icon_hash() );
+        if ( size ) {
+            url.append( "?size=" ).append( static_cast<uint64_t>( size ) );
+        }
+        return url;
+    }
+
+} // namespace mybot
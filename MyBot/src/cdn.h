@@ -0,0 +1,117 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <cstdint>
+#include <string_view>
+
+namespace mybot {
+
+    namespace detail {
+        constexpr int hex_value( char c ) {
+            return ( c >= '0' && c <= '9' ) ? c - '0' : ( c >= 'a' && c <= 'f' ) ? c - 'a' + 10 : ( c >= 'A' && c <= 'F' ) ? c - 'A' + 10 : -1;
+        }
+
+        constexpr bool parse_hex64( const char *p, uint64_t &out ) {
+            uint64_t v = 0;
+            for ( int i = 0; i < 16; ++i ) {
+                int d = hex_value( p[i] );
+                if ( d < 0 ) {
+                    return false;
+                }
+                v = ( v << 4 ) | static_cast<uint64_t>( d );
+            }
+            out = v;
+            return true;
+        }
+
+        constexpr void format_hex64( uint64_t v, char *out ) {
+            constexpr char digits[] = "0123456789abcdef";
+            for ( int i = 15; i >= 0; --i, v >>= 4 ) {
+                out[i] = digits[v & 0xf];
+            }
+        }
+    } // namespace detail
+
+    /**
+     * @brief Parse a 32 character hex icon hash into its high and low 64 bits,
+     * the same layout as dpp::utility::iconhash::first and second.
+     * Usable in constant expressions.
+     *
+     * @param s Hash text, without any "a_" animated prefix
+     * @param first Receives the high 64 bits
+     * @param second Receives the low 64 bits
+     * @return bool False if s is not exactly 32 hex digits
+     */
+    constexpr bool parse_hash128( std::string_view s, uint64_t &first, uint64_t &second ) {
+        return s.size() == 32 && detail::parse_hex64( s.data(), first ) && detail::parse_hex64( s.data() + 16, second );
+    }
+
+    /**
+     * @brief Write a 128-bit icon hash as 32 lowercase hex digits. Usable in constant expressions.
+     *
+     * @param first High 64 bits
+     * @param second Low 64 bits
+     * @param out Buffer of at least 32 characters, not NUL terminated
+     */
+    constexpr void format_hash128( uint64_t first, uint64_t second, char *out ) {
+        detail::format_hex64( first, out );
+        detail::format_hex64( second, out + 16 );
+    }
+
+    /**
+     * @brief Set an iconhash from text without going through std::string
+     *
+     * @param h Hash to set
+     * @param s 32 hex digits
+     * @return bool False if s is not a valid hash; h is left unchanged
+     */
+    bool set_iconhash( dpp::utility::iconhash &h, std::string_view s );
+
+    /**
+     * @brief A CDN URL built in place. Holds its text inline so building one
+     * never allocates; view() stays valid as long as the object lives.
+     */
+    class cdn_url {
+    public:
+        /** Longest URL the builders produce, with room to spare */
+        static constexpr size_t capacity = 128;
+
+        std::string_view view() const {
+            return std::string_view( text, length );
+        }
+
+        operator std::string_view() const {
+            return view();
+        }
+
+    private:
+        friend cdn_url avatar_url( const dpp::user &u, uint16_t size );
+        friend cdn_url guild_icon_url( const dpp::guild &g, uint16_t size );
+
+        cdn_url &append( std::string_view s );
+        cdn_url &append( uint64_t v );
+        cdn_url &append_hash( const dpp::utility::iconhash &h, bool animated );
+
+        char text[capacity];
+        size_t length = 0;
+    };
+
+    /**
+     * @brief Equivalent of dpp::user::get_avatar_url() without allocating.
+     * Users without an avatar get their default embed avatar.
+     *
+     * @param u User to build the URL for
+     * @param size Optional power of two between 16 and 4096 for the ?size= parameter, 0 to omit it
+     * @return cdn_url URL of the user's avatar
+     */
+    cdn_url avatar_url( const dpp::user &u, uint16_t size = 0 );
+
+    /**
+     * @brief URL of a guild's icon, empty if the guild has none
+     *
+     * @param g Guild to build the URL for
+     * @param size Optional power of two between 16 and 4096 for the ?size= parameter, 0 to omit it
+     * @return cdn_url URL of the guild's icon
+     */
+    cdn_url guild_icon_url( const dpp::guild &g, uint16_t size = 0 );
+
+} // namespace mybot
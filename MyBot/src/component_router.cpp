@@ -0,0 +1,111 @@
+#include "component_router.h"
+#include "snowflake.h"
+#include <stdexcept>
+
+namespace mybot {
+
+    namespace {
+        /* FNV-1a; custom ids are at most 100 bytes so a simple byte loop is enough */
+        uint64_t hash_name( std::string_view s ) {
+            uint64_t h = 0xcbf29ce484222325ull;
+            for ( char c : s ) {
+                h = ( h ^ static_cast<unsigned char>( c ) ) * 0x100000001b3ull;
+            }
+            return h;
+        }
+
+        /* Split off the first segment of s, leaving the remainder (without the separator) in s */
+        std::string_view next_segment( std::string_view &s, bool &more ) {
+            size_t sep = s.find( route_table::separator );
+            std::string_view head = s.substr( 0, sep );
+            more = sep != std::string_view::npos;
+            s.remove_prefix( more ? sep + 1 : s.size() );
+            return head;
+        }
+    } // namespace
+
+    std::string_view route_params::get( std::string_view name ) const {
+        for ( size_t i = 0; names && i < count; ++i ) {
+            if ( ( *names )[i] == name ) {
+                return values[i];
+            }
+        }
+        return {};
+    }
+
+    dpp::snowflake route_params::id( std::string_view name ) const {
+        return to_snowflake( get( name ) );
+    }
+
+    size_t route_table::add( std::string_view pattern ) {
+        route r;
+        bool more = true;
+        std::string_view rest = pattern;
+        r.name = std::string( next_segment( rest, more ) );
+        if ( r.name.empty() || r.name.front() == '{' || r.name == "*" ) {
+            throw std::invalid_argument( "Component route must start with a literal name" );
+        }
+        while ( more ) {
+            std::string_view s = next_segment( rest, more );
+            if ( s == "*" && !more ) {
+                r.wildcard = true;
+            }
+            else if ( s.size() >= 2 && s.front() == '{' && s.back() == '}' ) {
+                r.param_names.emplace_back( s.substr( 1, s.size() - 2 ) );
+                r.segments.push_back( { std::string(), true } );
+            }
+            else {
+                r.segments.push_back( { std::string( s ), false } );
+            }
+        }
+        if ( r.param_names.size() > route_params::max_params ) {
+            throw std::invalid_argument( "Component route has too many parameters" );
+        }
+
+        routes.push_back( std::move( r ) );
+        by_name[hash_name( routes.back().name )].push_back( routes.size() - 1 );
+        return routes.size() - 1;
+    }
+
+    bool route_table::match_route( const route &r, std::string_view rest, route_params &params, bool more ) const {
+        params.names = &r.param_names;
+        params.count = 0;
+        params.tail = {};
+        for ( const segment &seg : r.segments ) {
+            if ( !more ) {
+                return false;
+            }
+            std::string_view s = next_segment( rest, more );
+            if ( seg.capture ) {
+                params.values[params.count++] = s;
+            }
+            else if ( s != seg.text ) {
+                return false;
+            }
+        }
+        if ( r.wildcard ) {
+            params.tail = rest;
+            return true;
+        }
+        return !more;
+    }
+
+    bool route_table::match( std::string_view custom_id, size_t &route, route_params &params ) const {
+        bool more;
+        std::string_view rest = custom_id;
+        std::string_view name = next_segment( rest, more );
+        auto candidates = by_name.find( hash_name( name ) );
+        if ( candidates == by_name.end() ) {
+            return false;
+        }
+        for ( size_t index : candidates->second ) {
+            const auto &r = routes[index];
+            if ( r.name == name && match_route( r, rest, params, more ) ) {
+                route = index;
+                return true;
+            }
+        }
+        return false;
+    }
+
+} // namespace mybot
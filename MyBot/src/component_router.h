@@ -0,0 +1,152 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief Path parameters extracted from a custom_id by a component_router.
+     * Values are views into the event's custom_id.
+     */
+    class route_params {
+    public:
+        /** Most parameters one route can capture */
+        static constexpr size_t max_params = 8;
+
+        size_t size() const {
+            return count;
+        }
+
+        /**
+         * @brief Parameter by position, in pattern order
+         */
+        std::string_view operator[]( size_t i ) const {
+            return i < count ? values[i] : std::string_view();
+        }
+
+        /**
+         * @brief Parameter by name, or an empty view if the route has no such parameter
+         */
+        std::string_view get( std::string_view name ) const;
+
+        /**
+         * @brief Parameter parsed as a snowflake, 0 if missing or not a number
+         */
+        dpp::snowflake id( std::string_view name ) const;
+
+        /**
+         * @brief Everything matched by a trailing '*' in the pattern, separators included
+         */
+        std::string_view rest() const {
+            return tail;
+        }
+
+    private:
+        friend class route_table;
+
+        std::string_view values[max_params];
+        const std::vector<std::string> *names = nullptr;
+        size_t count = 0;
+        std::string_view tail;
+    };
+
+    /**
+     * @brief custom_id patterns indexed by the hash of their first segment.
+     * Patterns are segments separated by ':', e.g. "poll:{poll}:vote:{choice}":
+     * the first segment is the route name, "{x}" captures one segment as
+     * parameter x and a final "*" matches whatever remains. Matching needs no
+     * allocation.
+     */
+    class route_table {
+    public:
+        /** Segment separator in custom ids */
+        static constexpr char separator = ':';
+
+        /**
+         * @brief Add a pattern
+         *
+         * @param pattern Pattern as described above
+         * @return size_t Index of the route, in the order added
+         * @throws std::invalid_argument if the pattern is empty, starts with a
+         * parameter or captures more than route_params::max_params
+         */
+        size_t add( std::string_view pattern );
+
+        /**
+         * @brief Find the first added route matching a custom_id
+         *
+         * @param custom_id Id to match
+         * @param route Receives the index of the matching route
+         * @param params Receives the captured parameters
+         * @return bool True if a route matched
+         */
+        bool match( std::string_view custom_id, size_t &route, route_params &params ) const;
+
+    private:
+        struct segment {
+            std::string text;
+            bool capture;
+        };
+
+        struct route {
+            std::string name;
+            std::vector<segment> segments;
+            std::vector<std::string> param_names;
+            bool wildcard = false;
+        };
+
+        bool match_route( const route &r, std::string_view rest, route_params &params, bool more ) const;
+
+        std::vector<route> routes;
+        std::unordered_map<uint64_t, std::vector<size_t>> by_name;
+    };
+
+    /**
+     * @brief Dispatches component interactions to the handler registered for
+     * their custom_id, so each feature registers its own ids instead of sharing
+     * one on_button_click or on_select_click lambda.
+     *
+     * @tparam Event dpp::button_click_t or dpp::select_click_t
+     */
+    template <typename Event> class component_router {
+    public:
+        using handler_t = std::function<void( const Event &, const route_params & )>;
+
+        /**
+         * @brief Register a handler for a custom_id pattern, see route_table
+         *
+         * @return component_router& Reference to self, for chaining
+         */
+        component_router &add( std::string_view pattern, handler_t handler ) {
+            table.add( pattern );
+            handlers.push_back( std::move( handler ) );
+            return *this;
+        }
+
+        /**
+         * @brief Call the handler for the event's custom_id
+         *
+         * @param event Component interaction
+         * @return bool False if no route matched, so the caller can apply a default
+         */
+        bool dispatch( const Event &event ) const {
+            size_t index;
+            route_params params;
+            if ( !table.match( event.custom_id, index, params ) ) {
+                return false;
+            }
+            handlers[index]( event, params );
+            return true;
+        }
+
+    private:
+        route_table table;
+        std::vector<handler_t> handlers;
+    };
+
+} // namespace mybot
@@ -0,0 +1,134 @@
+#include "component_state.h"
+#include <algorithm>
+#include <array>
+
+namespace mybot {
+
+    namespace {
+        constexpr char alphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz-_";
+        constexpr uint8_t invalid = 0xff;
+
+        constexpr std::array<uint8_t, 256> make_decode_table() {
+            std::array<uint8_t, 256> t{};
+            for ( auto &v : t ) {
+                v = invalid;
+            }
+            for ( uint8_t i = 0; i < 64; ++i ) {
+                t[static_cast<unsigned char>( alphabet[i] )] = i;
+            }
+            return t;
+        }
+
+        constexpr std::array<uint8_t, 256> decode_table = make_decode_table();
+
+        /* 48 bits of tag, as 8 characters */
+        constexpr size_t tag_chars = 8;
+
+        void make_tag( const hmac_sha256 &key, std::string_view payload, char *out ) {
+            uint8_t digest[sha256::digest_size];
+            key.sign( payload, digest );
+            uint64_t bits = 0;
+            for ( int i = 0; i < 6; ++i ) {
+                bits |= static_cast<uint64_t>( digest[i] ) << ( i * 8 );
+            }
+            for ( size_t i = 0; i < tag_chars; ++i, bits >>= 6 ) {
+                out[i] = alphabet[bits & 63];
+            }
+        }
+
+        inline uint64_t low_bits( uint64_t v, unsigned bits ) {
+            return bits >= 64 ? v : v & ( ( uint64_t( 1 ) << bits ) - 1 );
+        }
+    } // namespace
+
+    state_writer &state_writer::put( uint64_t value, unsigned bits ) {
+        /* Once full, pending is no longer drained, so adding to it would shift past 64 bits */
+        if ( overflow ) {
+            return *this;
+        }
+        if ( bits > 32 ) {
+            put( value, 32 );
+            return put( value >> 32, bits - 32 );
+        }
+        /* pending holds fewer than 6 bits, so 32 more always fit */
+        pending |= low_bits( value, bits ) << pending_bits;
+        pending_bits += bits;
+        while ( pending_bits >= 6 ) {
+            if ( length == sizeof( text ) ) {
+                overflow = true;
+                return *this;
+            }
+            text[length++] = alphabet[pending & 63];
+            pending >>= 6;
+            pending_bits -= 6;
+        }
+        return *this;
+    }
+
+    bool state_writer::append_to( std::string &custom_id, const hmac_sha256 *key ) const {
+        size_t n = length + ( pending_bits ? 1 : 0 ) + ( key ? tag_chars : 0 );
+        if ( overflow || custom_id.size() + n > custom_id_limit ) {
+            return false;
+        }
+
+        /* The tag covers the whole custom_id, route prefix included, so state
+         * signed for one route is rejected by every other */
+        char signed_id[custom_id_limit];
+        size_t end = custom_id.size();
+        std::copy_n( custom_id.data(), end, signed_id );
+        end = std::copy_n( text, length, signed_id + end ) - signed_id;
+        if ( pending_bits ) {
+            signed_id[end++] = alphabet[pending & 63];
+        }
+        if ( key ) {
+            make_tag( *key, std::string_view( signed_id, end ), signed_id + end );
+            end += tag_chars;
+        }
+        custom_id.append( signed_id + custom_id.size(), end - custom_id.size() );
+        return true;
+    }
+
+    state_reader::state_reader( std::string_view custom_id, std::string_view encoded, const hmac_sha256 *key ) : text( encoded ) {
+        if ( !key ) {
+            return;
+        }
+        /* The tag is over the custom_id up to the tag itself, so the state must end it */
+        if ( text.size() < tag_chars || encoded.data() < custom_id.data() || encoded.data() + encoded.size() != custom_id.data() + custom_id.size() ) {
+            good = false;
+            return;
+        }
+        text.remove_suffix( tag_chars );
+        char expected[tag_chars];
+        make_tag( *key, custom_id.substr( 0, custom_id.size() - tag_chars ), expected );
+        /* Compare every character so the time taken does not reveal a matching prefix */
+        unsigned diff = 0;
+        for ( size_t i = 0; i < tag_chars; ++i ) {
+            diff |= static_cast<unsigned char>( expected[i] ^ encoded[text.size() + i] );
+        }
+        good = diff == 0;
+    }
+
+    uint64_t state_reader::get( unsigned bits ) {
+        if ( bits > 32 ) {
+            uint64_t low = get( 32 );
+            return low | ( get( bits - 32 ) << 32 );
+        }
+        while ( good && pending_bits < bits ) {
+            uint8_t v = pos < text.size() ? decode_table[static_cast<unsigned char>( text[pos++] )] : invalid;
+            if ( v == invalid ) {
+                good = false;
+                break;
+            }
+            pending |= static_cast<uint64_t>( v ) << pending_bits;
+            pending_bits += 6;
+        }
+        if ( !good ) {
+            return 0;
+        }
+        uint64_t value = low_bits( pending, bits );
+        pending >>= bits;
+        pending_bits -= bits;
+        return value;
+    }
+
+} // namespace mybot
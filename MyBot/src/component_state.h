@@ -0,0 +1,115 @@
+#pragma once
+#include <dpp/discord.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include "sha256.h"
+
+namespace mybot {
+
+    /** Longest custom_id Discord accepts */
+    constexpr size_t custom_id_limit = 100;
+
+    /**
+     * @brief Packs typed fields into a compact string for a component custom_id,
+     * so button and select state travels with the message instead of living in a
+     * server-side map. Fields are bit-packed and written six bits per character
+     * using [0-9A-Za-z-_], which never contains the router's ':' separator. With a
+     * key, a 48-bit HMAC-SHA256 tag (8 characters) over the whole custom_id is
+     * appended, so clicks cannot forge state or replay it on another route.
+     *
+     * @code
+     * std::string id = "count:";
+     * mybot::state_writer().put_id( user ).put( clicks, 16 ).append_to( id, &key );
+     * @endcode
+     */
+    class state_writer {
+    public:
+        /**
+         * @brief Add an unsigned field
+         *
+         * @param value Value; bits above the field width are dropped
+         * @param bits Field width, 1 to 64
+         */
+        state_writer &put( uint64_t value, unsigned bits );
+
+        state_writer &put_bool( bool value ) {
+            return put( value, 1 );
+        }
+
+        state_writer &put_id( dpp::snowflake id ) {
+            return put( id, 64 );
+        }
+
+        template <typename E> state_writer &put_enum( E value, unsigned bits ) {
+            return put( static_cast<uint64_t>( value ), bits );
+        }
+
+        /**
+         * @brief Append the encoded state, and its tag if a key is given. The state
+         * must be the last thing in the custom_id.
+         *
+         * @param custom_id Usually holds the route prefix already; the tag covers it too
+         * @param key Signing key, or nullptr for unsigned state
+         * @return bool False if the result would exceed custom_id_limit; custom_id is then unchanged
+         */
+        bool append_to( std::string &custom_id, const hmac_sha256 *key = nullptr ) const;
+
+    private:
+        char text[custom_id_limit];
+        size_t length = 0;
+        uint64_t pending = 0;
+        unsigned pending_bits = 0;
+        bool overflow = false;
+    };
+
+    /**
+     * @brief Reads fields written by state_writer, in the same order and widths.
+     * Decoding works directly on the custom_id view and never allocates. Errors
+     * are sticky: check ok() once after reading every field.
+     */
+    class state_reader {
+    public:
+        /**
+         * @brief Start reading, verifying the tag first if a key is given
+         *
+         * @param custom_id The whole custom_id, which the tag covers
+         * @param encoded The encoded part, a view into the end of custom_id, e.g. a route parameter
+         * @param key Key the state was signed with, or nullptr for unsigned state
+         */
+        state_reader( std::string_view custom_id, std::string_view encoded, const hmac_sha256 *key = nullptr );
+
+        /**
+         * @brief Read an unsigned field, or 0 once an error has occurred
+         */
+        uint64_t get( unsigned bits );
+
+        bool get_bool() {
+            return get( 1 ) != 0;
+        }
+
+        dpp::snowflake get_id() {
+            return get( 64 );
+        }
+
+        template <typename E> E get_enum( unsigned bits ) {
+            return static_cast<E>( get( bits ) );
+        }
+
+        /**
+         * @brief False if the tag did not verify, a character was invalid or a read ran past the end
+         */
+        bool ok() const {
+            return good;
+        }
+
+    private:
+        std::string_view text;
+        size_t pos = 0;
+        uint64_t pending = 0;
+        unsigned pending_bits = 0;
+        bool good = true;
+    };
+
+} // namespace mybot
@@ -0,0 +1,82 @@
+#include "gateway_monitor.h"
+#include <chrono>
+#include <iostream>
+
+namespace mybot {
+
+    namespace {
+        /* Seconds past one heartbeat interval before a missing ACK counts as a zombie connection */
+        constexpr time_t zombie_grace = 5;
+
+        constexpr auto poll_interval = std::chrono::milliseconds( 250 );
+    } // namespace
+
+    gateway_monitor::gateway_monitor( metrics &stats ) : stats( stats ) {}
+
+    gateway_monitor::~gateway_monitor() {
+        stop();
+    }
+
+    void gateway_monitor::start() {
+        if ( running.exchange( true ) ) {
+            return;
+        }
+        poller = std::thread( &gateway_monitor::run, this );
+    }
+
+    void gateway_monitor::stop() {
+        if ( !running.exchange( false ) ) {
+            return;
+        }
+        if ( poller.joinable() ) {
+            poller.join();
+        }
+    }
+
+    double gateway_monitor::gateway_ping() const {
+        double total = 0;
+        size_t counted = 0;
+        for ( const auto &s : stats.shards() ) {
+            if ( s.second->last_heartbeat_ack != 0 ) {
+                total += s.second->websocket_ping;
+                ++counted;
+            }
+        }
+        return counted ? total / counted : 0.0;
+    }
+
+    void gateway_monitor::run() {
+        while ( running ) {
+            poll();
+            std::this_thread::sleep_for( poll_interval );
+        }
+    }
+
+    void gateway_monitor::poll() {
+        time_t now = time( nullptr );
+        /* Not get_shards(): cluster::start may still be adding to it while on_ready has already started us */
+        for ( const auto &s : stats.shards() ) {
+            dpp::discord_client *shard = s.second;
+            if ( !shard->is_connected() || shard->heartbeat_interval == 0 || shard->last_heartbeat_ack == 0 ) {
+                continue;
+            }
+
+            shard_state &state = shards[s.first];
+            if ( shard->last_heartbeat_ack != state.last_ack ) {
+                state.last_ack = shard->last_heartbeat_ack;
+                state.zombie = false;
+                stats.observe_heartbeat( s.first, shard->websocket_ping );
+                continue;
+            }
+
+            time_t allowed = shard->heartbeat_interval / 1000 + zombie_grace;
+            if ( !state.zombie && now - state.last_ack > allowed ) {
+                state.zombie = true;
+                stats.count_zombie( s.first );
+                std::cout << "Shard " << s.first << ": no heartbeat ACK for " << ( now - state.last_ack )
+                          << " s, connection looks dead\n";
+            }
+        }
+    }
+
+} // namespace mybot
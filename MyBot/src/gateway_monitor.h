@@ -0,0 +1,69 @@
+#pragma once
+#include <dpp/dpp.h>
+#include "metrics.h"
+#include <atomic>
+#include <cstdint>
+#include <ctime>
+#include <thread>
+#include <unordered_map>
+
+namespace mybot {
+
+    /**
+     * @brief Watches every shard's heartbeat acknowledgements.
+     *
+     * Each new ACK's round-trip time is recorded in the shard's heartbeat
+     * histogram in mybot::metrics. A shard whose last ACK is older than one
+     * heartbeat interval plus a grace period is reported as a zombie
+     * connection, so it shows up before Discord drops the session.
+     *
+     * Shards are taken from metrics::shards(), so a shard is watched once it
+     * has dispatched its first counted event (normally READY).
+     */
+    class gateway_monitor {
+    public:
+        /**
+         * @brief Construct a new gateway monitor
+         *
+         * @param stats Metrics to find the shards in and record round-trip times and zombie detections in
+         */
+        explicit gateway_monitor( metrics &stats );
+
+        /**
+         * @brief Stops the polling thread
+         */
+        ~gateway_monitor();
+
+        /**
+         * @brief Start polling the shards on a background thread
+         */
+        void start();
+
+        /**
+         * @brief Stop polling and join the background thread
+         */
+        void stop();
+
+        /**
+         * @brief Gateway latency averaged over all shards that have received an ACK
+         *
+         * @return double Round-trip time in seconds, 0 if no shard has one yet
+         */
+        double gateway_ping() const;
+
+    private:
+        struct shard_state {
+            time_t last_ack = 0;
+            bool zombie = false;
+        };
+
+        void run();
+        void poll();
+
+        metrics &stats;
+        std::unordered_map<uint32_t, shard_state> shards;
+        std::atomic<bool> running{ false };
+        std::thread poller;
+    };
+
+} // namespace mybot
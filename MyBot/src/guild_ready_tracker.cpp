@@ -0,0 +1,84 @@
+#include "guild_ready_tracker.h"
+#include "snowflake.h"
+#include <dpp/nlohmann/json.hpp>
+#include <iostream>
+#include <string>
+
+namespace mybot {
+
+    namespace {
+        double elapsed_ms( std::chrono::steady_clock::time_point since ) {
+            return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - since ).count();
+        }
+    } // namespace
+
+    guild_ready_tracker::guild_ready_tracker( dpp::cluster &bot ) : bot( bot ) {}
+
+    void guild_ready_tracker::on_ready( const dpp::ready_t &event ) {
+        shard_state state;
+        state.ready_at = clock::now();
+
+        /* READY only carries the ids of the guilds that will follow as GUILD_CREATE */
+        nlohmann::json j = nlohmann::json::parse( event.raw_event, nullptr, false );
+        if ( !j.is_discarded() && j.contains( "d" ) && j["d"].contains( "guilds" ) ) {
+            for ( const auto &g : j["d"]["guilds"] ) {
+                state.pending.insert( to_snowflake( g["id"].get_ref<const std::string &>() ) );
+            }
+        }
+        state.total = state.pending.size();
+
+        std::lock_guard<std::mutex> guard( state_mutex );
+        if ( shards.empty() ) {
+            first_ready = state.ready_at;
+        }
+        shard_state &slot = shards[event.shard_id] = std::move( state );
+        if ( slot.pending.empty() ) {
+            finish_shard( event.shard_id, slot );
+        }
+    }
+
+    void guild_ready_tracker::on_guild_create( const dpp::guild_create_t &event ) {
+        if ( event.created == nullptr || event.from == nullptr ) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard( state_mutex );
+        auto it = shards.find( event.from->shard_id );
+        if ( it == shards.end() || it->second.finished ) {
+            return;
+        }
+        if ( it->second.pending.erase( event.created->id ) && it->second.pending.empty() ) {
+            finish_shard( it->first, it->second );
+        }
+    }
+
+    void guild_ready_tracker::finish_shard( uint32_t shard_id, shard_state &state ) {
+        state.finished = true;
+        std::cout << "Shard " << shard_id << ": " << state.total << " guilds available "
+                  << elapsed_ms( state.ready_at ) << " ms after READY\n";
+
+        if ( cluster_reported ) {
+            return;
+        }
+        /* cluster::start adds shards to get_shards() one at a time, so compare against the
+         * number of shards this cluster runs rather than walking a map still being filled.
+         * A shard that reconnects replaces its own entry, so it is never counted twice. */
+        size_t finished_shards = 0;
+        for ( const auto &s : shards ) {
+            finished_shards += s.second.finished;
+        }
+        size_t expected = 0;
+        for ( uint32_t id = 0; id < bot.numshards; ++id ) {
+            if ( id % bot.maxclusters == bot.cluster_id ) {
+                ++expected;
+            }
+        }
+        if ( finished_shards < expected ) {
+            return;
+        }
+        cluster_reported = true;
+        std::cout << "All " << shards.size() << " shards ready, "
+                  << elapsed_ms( first_ready ) << " ms after the first READY\n";
+    }
+
+} // namespace mybot
@@ -0,0 +1,61 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace mybot {
+
+    /**
+     * @brief Measures how long each shard takes to go from READY to having every
+     * guild listed in its READY payload delivered through GUILD_CREATE.
+     *
+     * The tracker is fed from the cluster's ready and guild_create handlers and
+     * prints one line per shard once its last guild becomes available, plus one
+     * line for the whole cluster when every shard has finished.
+     */
+    class guild_ready_tracker {
+    public:
+        /**
+         * @brief Construct a new tracker
+         *
+         * @param bot Cluster whose shards are tracked
+         */
+        explicit guild_ready_tracker( dpp::cluster &bot );
+
+        /**
+         * @brief Start timing a shard. Call from the cluster's on_ready handler.
+         *
+         * @param event READY event, its raw payload lists the unavailable guilds
+         */
+        void on_ready( const dpp::ready_t &event );
+
+        /**
+         * @brief Mark a guild as available. Call from the cluster's on_guild_create handler.
+         *
+         * @param event GUILD_CREATE event
+         */
+        void on_guild_create( const dpp::guild_create_t &event );
+
+    private:
+        using clock = std::chrono::steady_clock;
+
+        struct shard_state {
+            std::unordered_set<dpp::snowflake> pending;
+            size_t total = 0;
+            clock::time_point ready_at;
+            bool finished = false;
+        };
+
+        void finish_shard( uint32_t shard_id, shard_state &state );
+
+        dpp::cluster &bot;
+        std::mutex state_mutex;
+        std::unordered_map<uint32_t, shard_state> shards;
+        clock::time_point first_ready;
+        bool cluster_reported = false;
+    };
+
+} // namespace mybot
@@ -0,0 +1,157 @@
+#include "json_writer.h"
+#include <array>
+#include <charconv>
+
+namespace mybot {
+
+    namespace {
+        /* 0 = copy as is, 'u' = \u00XX, anything else = backslash followed by that character */
+        constexpr std::array<char, 256> make_escape_table() {
+            std::array<char, 256> t{};
+            for ( int c = 0; c < 0x20; ++c ) {
+                t[c] = 'u';
+            }
+            t['\b'] = 'b';
+            t['\f'] = 'f';
+            t['\n'] = 'n';
+            t['\r'] = 'r';
+            t['\t'] = 't';
+            t['"'] = '"';
+            t['\\'] = '\\';
+            return t;
+        }
+
+        constexpr std::array<char, 256> escape_table = make_escape_table();
+
+        template <typename T> void append_integer( std::string &out, T v ) {
+            char buffer[24];
+            auto result = std::to_chars( buffer, buffer + sizeof( buffer ), v );
+            out.append( buffer, result.ptr );
+        }
+    } // namespace
+
+    json_writer::json_writer( std::string &out ) : out( out ) {}
+
+    void json_writer::separate() {
+        if ( after_key ) {
+            after_key = false;
+        }
+        else if ( !first ) {
+            out += ',';
+        }
+        first = false;
+    }
+
+    json_writer &json_writer::begin_object() {
+        separate();
+        out += '{';
+        first = true;
+        return *this;
+    }
+
+    json_writer &json_writer::end_object() {
+        out += '}';
+        first = false;
+        return *this;
+    }
+
+    json_writer &json_writer::begin_array() {
+        separate();
+        out += '[';
+        first = true;
+        return *this;
+    }
+
+    json_writer &json_writer::end_array() {
+        out += ']';
+        first = false;
+        return *this;
+    }
+
+    json_writer &json_writer::key( std::string_view k ) {
+        separate();
+        escape( out, k );
+        out += ':';
+        after_key = true;
+        return *this;
+    }
+
+    json_writer &json_writer::value( std::string_view v ) {
+        separate();
+        escape( out, v );
+        return *this;
+    }
+
+    json_writer &json_writer::value( const char *v ) {
+        return value( std::string_view( v ) );
+    }
+
+    json_writer &json_writer::value( bool v ) {
+        separate();
+        out += v ? "true" : "false";
+        return *this;
+    }
+
+    json_writer &json_writer::value( int64_t v ) {
+        separate();
+        append_integer( out, v );
+        return *this;
+    }
+
+    json_writer &json_writer::value( uint64_t v ) {
+        separate();
+        append_integer( out, v );
+        return *this;
+    }
+
+    json_writer &json_writer::value( int32_t v ) {
+        return value( static_cast<int64_t>( v ) );
+    }
+
+    json_writer &json_writer::value( uint32_t v ) {
+        return value( static_cast<uint64_t>( v ) );
+    }
+
+    json_writer &json_writer::null() {
+        separate();
+        out += "null";
+        return *this;
+    }
+
+    json_writer &json_writer::snowflake( uint64_t id ) {
+        separate();
+        out += '"';
+        append_integer( out, id );
+        out += '"';
+        return *this;
+    }
+
+    void json_writer::escape( std::string &out, std::string_view s ) {
+        static constexpr char hex[] = "0123456789abcdef";
+        out.reserve( out.size() + s.size() + 2 );
+        out += '"';
+        size_t run = 0;
+        for ( size_t i = 0; i < s.size(); ++i ) {
+            char e = escape_table[static_cast<unsigned char>( s[i] )];
+            if ( e == 0 ) {
+                continue;
+            }
+            /* Flush the run of plain characters before this one in a single append */
+            out.append( s.data() + run, i - run );
+            run = i + 1;
+            out += '\\';
+            if ( e == 'u' ) {
+                unsigned char c = static_cast<unsigned char>( s[i] );
+                out += "u00";
+                out += hex[c >> 4];
+                out += hex[c & 0xf];
+            }
+            else {
+                out += e;
+            }
+        }
+        out.append( s.data() + run, s.size() - run );
+        out += '"';
+    }
+
+} // namespace mybot
@@ -0,0 +1,76 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief Streaming JSON writer that appends directly to a caller-owned string.
+     *
+     * Commas are inserted automatically between members and elements, so a
+     * payload is written in one pass with no intermediate DOM. Strings are
+     * escaped as nlohmann::json::dump() would, leaving UTF-8 untouched.
+     * Reusing the same output string across calls avoids reallocating it.
+     */
+    class json_writer {
+    public:
+        /**
+         * @brief Construct a writer appending to out
+         *
+         * @param out Buffer to append to. It is not cleared.
+         */
+        explicit json_writer( std::string &out );
+
+        json_writer &begin_object();
+        json_writer &end_object();
+        json_writer &begin_array();
+        json_writer &end_array();
+
+        /**
+         * @brief Write an object key; the next call writes its value
+         *
+         * @param k Key, escaped like any other string
+         */
+        json_writer &key( std::string_view k );
+
+        json_writer &value( std::string_view v );
+        json_writer &value( const char *v );
+        json_writer &value( bool v );
+        json_writer &value( int64_t v );
+        json_writer &value( uint64_t v );
+        json_writer &value( int32_t v );
+        json_writer &value( uint32_t v );
+        json_writer &null();
+
+        /**
+         * @brief Write a snowflake as Discord expects it, a decimal string
+         *
+         * @param id Snowflake value
+         */
+        json_writer &snowflake( uint64_t id );
+
+        /**
+         * @brief Shorthand for key( k ).value( v )
+         */
+        template <typename T> json_writer &member( std::string_view k, T v ) {
+            return key( k ).value( v );
+        }
+
+        /**
+         * @brief Append s to out as a quoted, escaped JSON string
+         *
+         * @param out Buffer to append to
+         * @param s String to escape
+         */
+        static void escape( std::string &out, std::string_view s );
+
+    private:
+        void separate();
+
+        std::string &out;
+        bool first = true;
+        bool after_key = false;
+    };
+
+} // namespace mybot
@@ -0,0 +1,227 @@
+#include "mentions.h"
+#include "snowflake.h"
+#include <algorithm>
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #include <emmintrin.h>
+    #define MYBOT_MENTIONS_SSE2
+#endif
+#ifdef _MSC_VER
+    #include <intrin.h>
+#endif
+
+namespace mybot {
+
+    namespace {
+        constexpr uint64_t ones = 0x0101010101010101ull;
+        constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+        inline uint64_t load8( const char *p ) {
+            uint64_t v;
+            std::memcpy( &v, p, sizeof( v ) );
+            return v;
+        }
+
+        /* Non-zero if any byte of x is zero */
+        inline uint64_t has_zero( uint64_t x ) {
+            return ( x - ones ) & ~x & high_bits;
+        }
+
+#ifdef MYBOT_MENTIONS_SSE2
+        inline unsigned lowest_bit( unsigned m ) {
+    #ifdef _MSC_VER
+            unsigned long i;
+            _BitScanForward( &i, m );
+            return static_cast<unsigned>( i );
+    #else
+            return static_cast<unsigned>( __builtin_ctz( m ) );
+    #endif
+        }
+#endif
+
+        /* Offset of the next '<' or ':' at or after i, or s.size(). Links are found
+         * from their "://" rather than their leading 'h', which is common in prose. */
+        size_t next_candidate( std::string_view s, size_t i ) {
+            const char *p = s.data();
+            const size_t n = s.size();
+#ifdef MYBOT_MENTIONS_SSE2
+            const __m128i angle = _mm_set1_epi8( '<' );
+            const __m128i colon = _mm_set1_epi8( ':' );
+            for ( ; i + 16 <= n; i += 16 ) {
+                __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( p + i ) );
+                unsigned mask = static_cast<unsigned>( _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, angle ), _mm_cmpeq_epi8( v, colon ) ) ) );
+                if ( mask ) {
+                    return i + lowest_bit( mask );
+                }
+            }
+#endif
+            for ( ; i + 8 <= n; i += 8 ) {
+                uint64_t v = load8( p + i );
+                if ( has_zero( v ^ ( '<' * ones ) ) | has_zero( v ^ ( ':' * ones ) ) ) {
+                    break;
+                }
+            }
+            while ( i < n && p[i] != '<' && p[i] != ':' ) {
+                ++i;
+            }
+            return i;
+        }
+
+        inline bool starts_with( std::string_view s, std::string_view prefix ) {
+            return s.substr( 0, prefix.size() ) == prefix;
+        }
+
+        inline bool is_word( char c ) {
+            return ( c >= 'a' && c <= 'z' ) || ( c >= 'A' && c <= 'Z' ) || ( c >= '0' && c <= '9' ) || c == '_';
+        }
+
+        /* Length of the scheme if s starts with one we linkify, else 0 */
+        size_t url_scheme( std::string_view s ) {
+            if ( starts_with( s, "https://" ) ) {
+                return 8;
+            }
+            if ( starts_with( s, "http://" ) ) {
+                return 7;
+            }
+            return 0;
+        }
+
+        /* Parse "<digits>>" at start; returns the offset just past '>' or 0 */
+        size_t match_id( std::string_view s, size_t start, dpp::snowflake &id ) {
+            std::string_view digits = s.substr( start, 21 );
+            size_t close = digits.find( '>' );
+            if ( close == std::string_view::npos || !parse_snowflake( digits.substr( 0, close ), id ) ) {
+                return 0;
+            }
+            return start + close + 1;
+        }
+
+        /* s starts with '<'; returns the token length or 0 */
+        size_t match_angle( std::string_view s, message_token &t ) {
+            size_t end = 0;
+            if ( starts_with( s, "<@&" ) ) {
+                t.type = tok_role;
+                end = match_id( s, 3, t.id );
+            }
+            else if ( starts_with( s, "<@!" ) ) {
+                t.type = tok_user;
+                end = match_id( s, 3, t.id );
+            }
+            else if ( starts_with( s, "<@" ) ) {
+                t.type = tok_user;
+                end = match_id( s, 2, t.id );
+            }
+            else if ( starts_with( s, "<#" ) ) {
+                t.type = tok_channel;
+                end = match_id( s, 2, t.id );
+            }
+            else if ( starts_with( s, "<:" ) || starts_with( s, "<a:" ) ) {
+                t.type = tok_emoji;
+                t.animated = s[1] == 'a';
+                size_t start = t.animated ? 3 : 2;
+                /* Emoji names are 2-32 word characters */
+                size_t len = 0;
+                while ( len <= 32 && start + len < s.size() && is_word( s[start + len] ) ) {
+                    ++len;
+                }
+                if ( len < 2 || len > 32 || start + len >= s.size() || s[start + len] != ':' ) {
+                    return 0;
+                }
+                t.name = s.substr( start, len );
+                end = match_id( s, start + len + 1, t.id );
+            }
+            else if ( size_t scheme = url_scheme( s.substr( 1 ) ) ) {
+                size_t close = s.find_first_of( "> \t\r\n", 1 );
+                if ( close == std::string_view::npos || s[close] != '>' || close <= scheme + 1 ) {
+                    return 0;
+                }
+                t.type = tok_url;
+                t.name = s.substr( 1, close - 1 );
+                end = close + 1;
+            }
+            if ( end ) {
+                t.text = s.substr( 0, end );
+            }
+            return end;
+        }
+
+        /* s starts with 'h'; returns the length of a bare link or 0 */
+        size_t match_url( std::string_view s, message_token &t ) {
+            size_t scheme = url_scheme( s );
+            if ( !scheme ) {
+                return 0;
+            }
+            size_t end = s.find_first_of( " \t\r\n<", scheme );
+            if ( end == std::string_view::npos ) {
+                end = s.size();
+            }
+            /* Trailing punctuation ends the sentence, not the link */
+            while ( end > scheme && std::string_view( ".,:;!?'\"" ).find( s[end - 1] ) != std::string_view::npos ) {
+                --end;
+            }
+            if ( end == scheme ) {
+                return 0;
+            }
+            t.type = tok_url;
+            t.text = t.name = s.substr( 0, end );
+            return end;
+        }
+    } // namespace
+
+    void token_list::push_back( const message_token &t ) {
+        if ( count < inline_capacity && spilled.empty() ) {
+            fixed[count++] = t;
+            return;
+        }
+        if ( spilled.empty() ) {
+            spilled.assign( fixed, fixed + count );
+        }
+        spilled.push_back( t );
+        ++count;
+    }
+
+    token_list scan_tokens( std::string_view content ) {
+        token_list tokens;
+        size_t i = 0, done = 0;
+        while ( ( i = next_candidate( content, i ) ) < content.size() ) {
+            message_token t;
+            size_t len = 0;
+            if ( content[i] == '<' ) {
+                len = match_angle( content.substr( i ), t );
+            }
+            else if ( content.compare( i, 3, "://" ) == 0 ) {
+                /* Step back over "http" or "https", which must not follow a word character or an earlier token */
+                size_t start = i >= 5 && content[i - 1] == 's' ? i - 5 : i - std::min<size_t>( i, 4 );
+                if ( start >= done && ( start == 0 || !is_word( content[start - 1] ) ) ) {
+                    len = match_url( content.substr( start ), t );
+                    if ( len ) {
+                        len -= i - start;
+                    }
+                }
+            }
+            if ( len ) {
+                tokens.push_back( t );
+                i = done = i + len;
+            }
+            else {
+                ++i;
+            }
+        }
+        return tokens;
+    }
+
+    bool parse_token( std::string_view s, message_token &out ) {
+        if ( s.empty() ) {
+            return false;
+        }
+        message_token t;
+        size_t len = s[0] == '<' ? match_angle( s, t ) : match_url( s, t );
+        if ( len == 0 || len != s.size() ) {
+            return false;
+        }
+        out = t;
+        return true;
+    }
+
+} // namespace mybot
@@ -0,0 +1,101 @@
+#pragma once
+#include <dpp/discord.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief Kinds of token found in message content
+     */
+    enum token_type : uint8_t {
+        /// <@id> or <@!id>
+        tok_user,
+        /// <@&id>
+        tok_role,
+        /// <#id>
+        tok_channel,
+        /// <:name:id> or <a:name:id>
+        tok_emoji,
+        /// http:// or https:// link, bare or wrapped in <> to suppress its embed
+        tok_url,
+    };
+
+    /**
+     * @brief A token found in message content. The views point into the scanned
+     * string, so they are only valid while it is.
+     */
+    struct message_token {
+        /** Kind of token */
+        token_type type = tok_user;
+        /** True for an animated custom emoji */
+        bool animated = false;
+        /** Parsed id; 0 for urls */
+        dpp::snowflake id = 0;
+        /** The whole token as written, including any angle brackets */
+        std::string_view text;
+        /** Emoji name, or the link itself for urls */
+        std::string_view name;
+    };
+
+    /**
+     * @brief List of tokens that keeps the first few inline and only allocates
+     * once a message has more than that, which almost none do.
+     */
+    class token_list {
+    public:
+        /** Number of tokens held without allocating */
+        static constexpr size_t inline_capacity = 8;
+
+        void push_back( const message_token &t );
+
+        size_t size() const {
+            return count;
+        }
+
+        bool empty() const {
+            return count == 0;
+        }
+
+        const message_token *begin() const {
+            return spilled.empty() ? fixed : spilled.data();
+        }
+
+        const message_token *end() const {
+            return begin() + count;
+        }
+
+        const message_token &operator[]( size_t i ) const {
+            return begin()[i];
+        }
+
+    private:
+        message_token fixed[inline_capacity];
+        std::vector<message_token> spilled;
+        size_t count = 0;
+    };
+
+    /**
+     * @brief Find all mentions, channel references, custom emojis and links in
+     * message content in one pass. Candidate '<' and ':' bytes are located
+     * 16 bytes at a time with SSE2 (8 at a time with SWAR otherwise) and ids are
+     * parsed with parse_snowflake(), so nothing is copied.
+     *
+     * @param content Message content
+     * @return token_list Tokens in the order they appear
+     */
+    token_list scan_tokens( std::string_view content );
+
+    /**
+     * @brief Parse a string that is exactly one token, e.g. a command parameter
+     * such as "<@!189759562910400512>"
+     *
+     * @param s Text to parse, without surrounding whitespace
+     * @param out Receives the token on success
+     * @return bool True if all of s is a single token
+     */
+    bool parse_token( std::string_view s, message_token &out );
+
+} // namespace mybot
@@ -0,0 +1,254 @@
+#include "message_cache.h"
+#include <dpp/fmt/format.h>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+namespace mybot {
+
+    namespace {
+        constexpr size_t min_block = 32;
+
+        /* Smallest size class whose blocks hold length bytes, clamped to the largest */
+        uint8_t class_for( size_t length, size_t classes ) {
+            uint8_t c = 0;
+            while ( c + 1u < classes && ( min_block << c ) < length ) {
+                ++c;
+            }
+            return c;
+        }
+    } // namespace
+
+    message_cache::message_cache( size_t per_channel, size_t max_bytes ) : per_channel( std::max<size_t>( per_channel, 1 ) ), max_bytes( max_bytes ) {}
+
+    message_cache::~message_cache() {
+        for ( auto &c : channels ) {
+            for ( auto &s : c.second.slots ) {
+                delete[] s.content;
+            }
+        }
+        for ( auto &blocks : free_blocks ) {
+            for ( char *b : blocks ) {
+                delete[] b;
+            }
+        }
+    }
+
+    void message_cache::watch( dpp::snowflake channel_id ) {
+        std::lock_guard<std::mutex> guard( lock );
+        ring &r = channels[channel_id];
+        if ( r.slots.empty() ) {
+            r.slots.resize( per_channel, slot{ 0, 0, nullptr, 0, 0 } );
+            bytes += per_channel * sizeof( slot );
+        }
+    }
+
+    void message_cache::unwatch( dpp::snowflake channel_id ) {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( channel_id );
+        if ( it == channels.end() ) {
+            return;
+        }
+        ring &r = it->second;
+        while ( r.count ) {
+            release( r.slots[r.head] );
+            r.head = ( r.head + 1 ) % r.slots.size();
+            --r.count;
+            --entries;
+        }
+        bytes -= r.slots.size() * sizeof( slot );
+        channels.erase( it );
+    }
+
+    void message_cache::store( slot &s, const std::string &content ) {
+        s.length = static_cast<uint32_t>( content.size() );
+        s.content = nullptr;
+        if ( content.empty() ) {
+            return;
+        }
+        s.size_class = class_for( content.size(), size_classes );
+        size_t block = min_block << s.size_class;
+        s.length = static_cast<uint32_t>( std::min( content.size(), block ) );
+        auto &pool = free_blocks[s.size_class];
+        if ( !pool.empty() ) {
+            s.content = pool.back();
+            pool.pop_back();
+            pooled_bytes -= block;
+        }
+        else {
+            s.content = new char[block];
+        }
+        std::memcpy( s.content, content.data(), s.length );
+        bytes += block;
+    }
+
+    void message_cache::release( slot &s ) {
+        if ( !s.content ) {
+            return;
+        }
+        size_t block = min_block << s.size_class;
+        bytes -= block;
+        auto &pool = free_blocks[s.size_class];
+        if ( pool.size() < pool_depth ) {
+            pool.push_back( s.content );
+            pooled_bytes += block;
+        }
+        else {
+            delete[] s.content;
+        }
+        s.content = nullptr;
+    }
+
+    void message_cache::copy_out( const slot &s, cached_message *out ) const {
+        if ( out ) {
+            out->id = s.id;
+            out->author_id = s.author_id;
+            out->content.assign( s.content ? s.content : "", s.length );
+        }
+    }
+
+    message_cache::slot *message_cache::locate( ring &r, dpp::snowflake id ) {
+        /* Newest first: edits and deletes mostly hit recent messages */
+        for ( size_t i = r.count; i > 0; --i ) {
+            slot &s = r.slots[( r.head + i - 1 ) % r.slots.size()];
+            if ( s.id == id ) {
+                return &s;
+            }
+        }
+        return nullptr;
+    }
+
+    void message_cache::evict_oldest( ring &r ) {
+        release( r.slots[r.head] );
+        r.head = ( r.head + 1 ) % r.slots.size();
+        --r.count;
+        --entries;
+    }
+
+    void message_cache::enforce_cap() {
+        while ( bytes > max_bytes && entries ) {
+            ring *oldest = nullptr;
+            for ( auto &c : channels ) {
+                ring &r = c.second;
+                if ( r.count && ( !oldest || r.slots[r.head].id < oldest->slots[oldest->head].id ) ) {
+                    oldest = &r;
+                }
+            }
+            evict_oldest( *oldest );
+            ++cap_evictions;
+        }
+    }
+
+    void message_cache::insert( const dpp::message &m ) {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( m.channel_id );
+        if ( it == channels.end() ) {
+            return;
+        }
+        ring &r = it->second;
+        if ( r.count == r.slots.size() ) {
+            evict_oldest( r );
+            ++ring_evictions;
+        }
+        slot &s = r.slots[( r.head + r.count ) % r.slots.size()];
+        s.id = m.id;
+        s.author_id = m.author ? m.author->id : 0;
+        store( s, m.content );
+        ++r.count;
+        ++entries;
+        enforce_cap();
+    }
+
+    bool message_cache::update( const dpp::message &m, cached_message *before ) {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( m.channel_id );
+        slot *s = it == channels.end() ? nullptr : locate( it->second, m.id );
+        if ( !s ) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        copy_out( *s, before );
+        release( *s );
+        store( *s, m.content );
+        enforce_cap();
+        return true;
+    }
+
+    bool message_cache::erase( dpp::snowflake channel_id, dpp::snowflake id, cached_message *removed ) {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( channel_id );
+        slot *s = it == channels.end() ? nullptr : locate( it->second, id );
+        if ( !s ) {
+            ++misses;
+            return false;
+        }
+        ++hits;
+        copy_out( *s, removed );
+        release( *s );
+
+        /* Close the gap so the ring stays in arrival order */
+        ring &r = it->second;
+        const size_t n = r.slots.size();
+        size_t i = ( static_cast<size_t>( s - r.slots.data() ) + n - r.head ) % n;
+        for ( ; i + 1 < r.count; ++i ) {
+            r.slots[( r.head + i ) % n] = r.slots[( r.head + i + 1 ) % n];
+        }
+        r.slots[( r.head + r.count - 1 ) % n].content = nullptr;
+        --r.count;
+        --entries;
+        return true;
+    }
+
+    bool message_cache::find( dpp::snowflake channel_id, dpp::snowflake id, cached_message &out ) const {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( channel_id );
+        if ( it != channels.end() ) {
+            const ring &r = it->second;
+            for ( size_t i = r.count; i > 0; --i ) {
+                const slot &s = r.slots[( r.head + i - 1 ) % r.slots.size()];
+                if ( s.id == id ) {
+                    ++hits;
+                    copy_out( s, &out );
+                    return true;
+                }
+            }
+        }
+        ++misses;
+        return false;
+    }
+
+    size_t message_cache::collect( dpp::snowflake channel_id, std::vector<cached_message> &out ) const {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = channels.find( channel_id );
+        if ( it == channels.end() ) {
+            return 0;
+        }
+        const ring &r = it->second;
+        out.reserve( out.size() + r.count );
+        for ( size_t i = r.count; i > 0; --i ) {
+            out.emplace_back();
+            copy_out( r.slots[( r.head + i - 1 ) % r.slots.size()], &out.back() );
+        }
+        return r.count;
+    }
+
+    void message_cache::render( std::string &out ) const {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = std::back_inserter( out );
+        out += "# TYPE mybot_message_cache_messages gauge\n";
+        fmt::format_to( it, "mybot_message_cache_messages {}\n", entries );
+        out += "# TYPE mybot_message_cache_channels gauge\n";
+        fmt::format_to( it, "mybot_message_cache_channels {}\n", channels.size() );
+        out += "# TYPE mybot_message_cache_bytes gauge\n";
+        fmt::format_to( it, "mybot_message_cache_bytes{{kind=\"live\"}} {}\n", bytes );
+        fmt::format_to( it, "mybot_message_cache_bytes{{kind=\"pooled\"}} {}\n", pooled_bytes );
+        out += "# TYPE mybot_message_cache_evictions_total counter\n";
+        fmt::format_to( it, "mybot_message_cache_evictions_total{{reason=\"ring\"}} {}\n", ring_evictions );
+        fmt::format_to( it, "mybot_message_cache_evictions_total{{reason=\"memory\"}} {}\n", cap_evictions );
+        out += "# TYPE mybot_message_cache_lookups_total counter\n";
+        fmt::format_to( it, "mybot_message_cache_lookups_total{{result=\"hit\"}} {}\n", hits );
+        fmt::format_to( it, "mybot_message_cache_lookups_total{{result=\"miss\"}} {}\n", misses );
+    }
+
+} // namespace mybot
@@ -0,0 +1,145 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief A message as kept by message_cache
+     */
+    struct cached_message {
+        dpp::snowflake id = 0;
+        dpp::snowflake author_id = 0;
+        std::string content;
+    };
+
+    /**
+     * @brief Opt-in cache of the most recent messages in selected channels, so
+     * edits and deletes can be compared against what was there before. D++
+     * does not cache messages, and dpp::message_delete_t only carries ids.
+     *
+     * Each watched channel has a ring of its last N messages stored as compact
+     * fixed-size slots, with content held in pooled power-of-two blocks that are
+     * recycled on eviction. A global byte cap evicts the oldest message across
+     * all channels (snowflakes are time ordered). All methods are thread safe.
+     */
+    class message_cache {
+    public:
+        /**
+         * @brief Construct a new message cache
+         *
+         * @param per_channel Messages kept per watched channel
+         * @param max_bytes Cap on slot and content memory across all channels
+         */
+        message_cache( size_t per_channel = 50, size_t max_bytes = size_t{ 4 } << 20 );
+
+        ~message_cache();
+
+        message_cache( const message_cache & ) = delete;
+        message_cache &operator=( const message_cache & ) = delete;
+
+        /**
+         * @brief Start caching messages posted in a channel
+         */
+        void watch( dpp::snowflake channel_id );
+
+        /**
+         * @brief Stop caching a channel and free its messages
+         */
+        void unwatch( dpp::snowflake channel_id );
+
+        /**
+         * @brief Cache a newly created message; ignored unless its channel is watched
+         */
+        void insert( const dpp::message &m );
+
+        /**
+         * @brief Replace a cached message's content with its edited version
+         *
+         * @param m Message from dpp::message_update_t
+         * @param before Receives the previous version, may be nullptr
+         * @return bool True if the message was cached
+         */
+        bool update( const dpp::message &m, cached_message *before = nullptr );
+
+        /**
+         * @brief Remove a deleted message
+         *
+         * @param channel_id Channel the message was in
+         * @param id Message id
+         * @param removed Receives the message as it was, may be nullptr
+         * @return bool True if the message was cached
+         */
+        bool erase( dpp::snowflake channel_id, dpp::snowflake id, cached_message *removed = nullptr );
+
+        /**
+         * @brief Look up a message without changing it
+         *
+         * @return bool True if found, in which case out is filled in
+         */
+        bool find( dpp::snowflake channel_id, dpp::snowflake id, cached_message &out ) const;
+
+        /**
+         * @brief Copy out every cached message in a channel, newest first
+         *
+         * @param channel_id Channel to read
+         * @param out Messages are appended here
+         * @return size_t Number of messages appended
+         */
+        size_t collect( dpp::snowflake channel_id, std::vector<cached_message> &out ) const;
+
+        /**
+         * @brief Append the cache's gauges and counters in Prometheus text format
+         *
+         * @param out Buffer to append to
+         */
+        void render( std::string &out ) const;
+
+    private:
+        /** Content blocks are 32 << n bytes; the largest holds a 4000 character message */
+        static constexpr size_t size_classes = 10;
+        /** Free blocks kept per size class for reuse */
+        static constexpr size_t pool_depth = 16;
+
+        struct slot {
+            dpp::snowflake id;
+            dpp::snowflake author_id;
+            char *content;
+            uint32_t length;
+            uint8_t size_class;
+        };
+
+        struct ring {
+            std::vector<slot> slots;
+            size_t head = 0;
+            size_t count = 0;
+        };
+
+        slot *locate( ring &r, dpp::snowflake id );
+        void store( slot &s, const std::string &content );
+        void release( slot &s );
+        void copy_out( const slot &s, cached_message *out ) const;
+        void evict_oldest( ring &r );
+        void enforce_cap();
+
+        const size_t per_channel;
+        const size_t max_bytes;
+
+        mutable std::mutex lock;
+        std::unordered_map<dpp::snowflake, ring> channels;
+        std::array<std::vector<char *>, size_classes> free_blocks;
+        size_t bytes = 0;
+        size_t pooled_bytes = 0;
+        size_t entries = 0;
+        uint64_t ring_evictions = 0;
+        uint64_t cap_evictions = 0;
+        mutable uint64_t hits = 0;
+        mutable uint64_t misses = 0;
+    };
+
+} // namespace mybot
@@ -0,0 +1,313 @@
+#include "metrics.h"
+#include <dpp/fmt/format.h>
+#include <iterator>
+
+#ifdef _WIN32
+    #include <ws2tcpip.h>
+    #define close_socket closesocket
+#else
+    #include <netinet/in.h>
+    #include <sys/select.h>
+    #include <sys/socket.h>
+    #include <sys/time.h>
+    #include <unistd.h>
+    #define close_socket ::close
+    #define INVALID_SOCKET -1
+#endif
+
+namespace mybot {
+
+    namespace {
+        constexpr const char *cache_names[ck_count] = { "user", "guild", "channel", "role", "emoji" };
+
+        void set_receive_timeout( SOCKET s, int seconds ) {
+#ifdef _WIN32
+            DWORD timeout = seconds * 1000;
+#else
+            timeval timeout{ seconds, 0 };
+#endif
+            setsockopt( s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char *>( &timeout ), sizeof( timeout ) );
+        }
+
+        /* Wait up to half a second for a connection so stop() is noticed promptly */
+        bool wait_readable( SOCKET s ) {
+            fd_set set;
+            FD_ZERO( &set );
+            FD_SET( s, &set );
+            timeval timeout{ 0, 500000 };
+            return select( static_cast<int>( s ) + 1, &set, nullptr, nullptr, &timeout ) > 0;
+        }
+
+        void send_all( SOCKET s, const std::string &data ) {
+            size_t sent = 0;
+            while ( sent < data.size() ) {
+                int n = send( s, data.data() + sent, static_cast<int>( data.size() - sent ), 0 );
+                if ( n <= 0 ) {
+                    return;
+                }
+                sent += static_cast<size_t>( n );
+            }
+        }
+    } // namespace
+
+    void histogram::observe( double seconds ) {
+        size_t i = 0;
+        while ( i < bounds.size() && seconds > bounds[i] ) {
+            ++i;
+        }
+        buckets[i].fetch_add( 1, std::memory_order_relaxed );
+        sum_us.fetch_add( static_cast<uint64_t>( seconds * 1e6 ), std::memory_order_relaxed );
+        count.fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void histogram::render( std::string &out, const char *name, const std::string &labels ) const {
+        auto it = std::back_inserter( out );
+        const char *sep = labels.empty() ? "" : ",";
+        uint64_t cumulative = 0;
+        for ( size_t i = 0; i < bounds.size(); ++i ) {
+            cumulative += buckets[i].load( std::memory_order_relaxed );
+            fmt::format_to( it, "{}_bucket{{{}{}le=\"{}\"}} {}\n", name, labels, sep, bounds[i], cumulative );
+        }
+        cumulative += buckets[bounds.size()].load( std::memory_order_relaxed );
+        fmt::format_to( it, "{}_bucket{{{}{}le=\"+Inf\"}} {}\n", name, labels, sep, cumulative );
+        const std::string braced = labels.empty() ? "" : "{" + labels + "}";
+        fmt::format_to( it, "{}_sum{} {}\n", name, braced, sum_us.load( std::memory_order_relaxed ) / 1e6 );
+        fmt::format_to( it, "{}_count{} {}\n", name, braced, count.load( std::memory_order_relaxed ) );
+    }
+
+    metrics::metrics( dpp::cluster &bot ) : bot( bot ), listener( INVALID_SOCKET ) {}
+
+    metrics::~metrics() {
+        stop();
+    }
+
+    size_t metrics::slot( uint32_t shard_id ) {
+        return shard_id < max_shards ? shard_id : max_shards - 1;
+    }
+
+    void metrics::count_event( const dpp::event_dispatch_t &event ) {
+        uint32_t shard_id = event.from ? event.from->shard_id : 0;
+        events[slot( shard_id )].fetch_add( 1, std::memory_order_relaxed );
+        if ( event.from && shard_id < max_shards && clients[shard_id].load( std::memory_order_relaxed ) != event.from ) {
+            clients[shard_id].store( event.from, std::memory_order_release );
+        }
+    }
+
+    std::vector<std::pair<uint32_t, dpp::discord_client *>> metrics::shards() const {
+        std::vector<std::pair<uint32_t, dpp::discord_client *>> out;
+        for ( uint32_t id = 0; id < max_shards; ++id ) {
+            if ( dpp::discord_client *client = clients[id].load( std::memory_order_acquire ) ) {
+                out.emplace_back( id, client );
+            }
+        }
+        return out;
+    }
+
+    void metrics::observe_heartbeat( uint32_t shard_id, double seconds ) {
+        heartbeat_rtt[slot( shard_id )].observe( seconds );
+    }
+
+    void metrics::count_zombie( uint32_t shard_id ) {
+        zombies[slot( shard_id )].fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    void metrics::count_cache_lookup( cache_kind kind, bool hit ) {
+        ( hit ? cache_hits : cache_misses )[kind].fetch_add( 1, std::memory_order_relaxed );
+    }
+
+    dpp::user *metrics::find_user( dpp::snowflake id ) {
+        dpp::user *u = dpp::find_user( id );
+        count_cache_lookup( ck_user, u != nullptr );
+        return u;
+    }
+
+    dpp::guild *metrics::find_guild( dpp::snowflake id ) {
+        dpp::guild *g = dpp::find_guild( id );
+        count_cache_lookup( ck_guild, g != nullptr );
+        return g;
+    }
+
+    dpp::channel *metrics::find_channel( dpp::snowflake id ) {
+        dpp::channel *c = dpp::find_channel( id );
+        count_cache_lookup( ck_channel, c != nullptr );
+        return c;
+    }
+
+    dpp::role *metrics::find_role( dpp::snowflake id ) {
+        dpp::role *r = dpp::find_role( id );
+        count_cache_lookup( ck_role, r != nullptr );
+        return r;
+    }
+
+    void metrics::observe_rest( const dpp::confirmation_callback_t &cc ) {
+        rest_latency.observe( cc.http_info.latency );
+        if ( cc.is_error() ) {
+            rest_errors.fetch_add( 1, std::memory_order_relaxed );
+        }
+    }
+
+    dpp::command_completion_event_t metrics::timed( dpp::command_completion_event_t callback ) {
+        return [this, callback]( const dpp::confirmation_callback_t &cc ) {
+            observe_rest( cc );
+            if ( callback ) {
+                callback( cc );
+            }
+        };
+    }
+
+    std::string metrics::render() const {
+        std::string out;
+        out.reserve( 4096 );
+        auto it = std::back_inserter( out );
+        const auto shard_list = shards();
+
+        out += "# HELP mybot_shard_handled_events_total Dispatched events the bot has handlers for, by shard\n";
+        out += "# TYPE mybot_shard_handled_events_total counter\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_handled_events_total{{shard=\"{}\"}} {}\n", s.first, events[slot( s.first )].load( std::memory_order_relaxed ) );
+        }
+
+        out += "# TYPE mybot_shard_heartbeat_rtt_seconds gauge\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_heartbeat_rtt_seconds{{shard=\"{}\"}} {}\n", s.first, s.second->websocket_ping );
+        }
+
+        out += "# TYPE mybot_shard_heartbeat_ack_seconds histogram\n";
+        for ( const auto &s : shard_list ) {
+            heartbeat_rtt[slot( s.first )].render( out, "mybot_shard_heartbeat_ack_seconds", fmt::format( "shard=\"{}\"", s.first ) );
+        }
+
+        out += "# TYPE mybot_shard_zombie_detections_total counter\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_zombie_detections_total{{shard=\"{}\"}} {}\n", s.first, zombies[slot( s.first )].load( std::memory_order_relaxed ) );
+        }
+
+        out += "# TYPE mybot_shard_queue_depth gauge\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_queue_depth{{shard=\"{}\"}} {}\n", s.first, s.second->GetQueueSize() );
+        }
+
+        out += "# TYPE mybot_shard_bytes_in_total counter\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_bytes_in_total{{shard=\"{}\"}} {}\n", s.first, s.second->get_bytes_in() );
+        }
+
+        out += "# TYPE mybot_shard_bytes_out_total counter\n";
+        for ( const auto &s : shard_list ) {
+            fmt::format_to( it, "mybot_shard_bytes_out_total{{shard=\"{}\"}} {}\n", s.first, s.second->get_bytes_out() );
+        }
+
+        out += "# TYPE mybot_shard_decompression_ratio gauge\n";
+        for ( const auto &s : shard_list ) {
+            uint64_t in = s.second->get_bytes_in();
+            double ratio = in ? static_cast<double>( s.second->get_decompressed_bytes_in() ) / in : 0.0;
+            fmt::format_to( it, "mybot_shard_decompression_ratio{{shard=\"{}\"}} {}\n", s.first, ratio );
+        }
+
+        out += "# TYPE mybot_cache_objects gauge\n";
+        const uint64_t sizes[ck_count] = { dpp::get_user_count(), dpp::get_guild_count(), dpp::get_channel_count(), dpp::get_role_count(), dpp::get_emoji_count() };
+        for ( size_t i = 0; i < ck_count; ++i ) {
+            fmt::format_to( it, "mybot_cache_objects{{cache=\"{}\"}} {}\n", cache_names[i], sizes[i] );
+        }
+
+        out += "# TYPE mybot_cache_lookups_total counter\n";
+        for ( size_t i = 0; i < ck_count; ++i ) {
+            fmt::format_to( it, "mybot_cache_lookups_total{{cache=\"{}\",result=\"hit\"}} {}\n", cache_names[i], cache_hits[i].load( std::memory_order_relaxed ) );
+            fmt::format_to( it, "mybot_cache_lookups_total{{cache=\"{}\",result=\"miss\"}} {}\n", cache_names[i], cache_misses[i].load( std::memory_order_relaxed ) );
+        }
+
+        out += "# TYPE mybot_rest_ping_seconds gauge\n";
+        fmt::format_to( it, "mybot_rest_ping_seconds {}\n", bot.rest_ping );
+
+        out += "# TYPE mybot_rest_errors_total counter\n";
+        fmt::format_to( it, "mybot_rest_errors_total {}\n", rest_errors.load( std::memory_order_relaxed ) );
+
+        out += "# TYPE mybot_rest_latency_seconds histogram\n";
+        rest_latency.render( out, "mybot_rest_latency_seconds", "" );
+
+        for ( const auto &collector : collectors ) {
+            collector( out );
+        }
+        return out;
+    }
+
+    void metrics::add_collector( std::function<void( std::string & )> collector ) {
+        collectors.push_back( std::move( collector ) );
+    }
+
+    bool metrics::listen( uint16_t port ) {
+        if ( running ) {
+            return true;
+        }
+
+        listener = socket( AF_INET, SOCK_STREAM, IPPROTO_TCP );
+        if ( listener == INVALID_SOCKET ) {
+            return false;
+        }
+
+        int yes = 1;
+        setsockopt( listener, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char *>( &yes ), sizeof( yes ) );
+
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl( INADDR_LOOPBACK );
+        addr.sin_port = htons( port );
+        if ( bind( listener, reinterpret_cast<sockaddr *>( &addr ), sizeof( addr ) ) != 0 || ::listen( listener, 8 ) != 0 ) {
+            close_socket( listener );
+            listener = INVALID_SOCKET;
+            return false;
+        }
+
+        running = true;
+        server = std::thread( &metrics::serve, this );
+        return true;
+    }
+
+    void metrics::stop() {
+        if ( !running.exchange( false ) ) {
+            return;
+        }
+        if ( server.joinable() ) {
+            server.join();
+        }
+        close_socket( listener );
+        listener = INVALID_SOCKET;
+    }
+
+    void metrics::serve() {
+        while ( running ) {
+            if ( !wait_readable( listener ) ) {
+                continue;
+            }
+            SOCKET client = accept( listener, nullptr, nullptr );
+            if ( client == INVALID_SOCKET ) {
+                continue;
+            }
+            set_receive_timeout( client, 2 );
+
+            /* Only the request line matters; read until the end of the headers */
+            std::string request;
+            char buffer[1024];
+            while ( request.size() < 8192 && request.find( "\r\n\r\n" ) == std::string::npos ) {
+                int n = recv( client, buffer, sizeof( buffer ), 0 );
+                if ( n <= 0 ) {
+                    break;
+                }
+                request.append( buffer, static_cast<size_t>( n ) );
+            }
+
+            std::string response;
+            if ( request.rfind( "GET /metrics ", 0 ) == 0 ) {
+                std::string body = render();
+                response = fmt::format( "HTTP/1.1 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: {}\r\nConnection: close\r\n\r\n", body.size() );
+                response += body;
+            }
+            else {
+                response = "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\nConnection: close\r\n\r\n";
+            }
+            send_all( client, response );
+            close_socket( client );
+        }
+    }
+
+} // namespace mybot
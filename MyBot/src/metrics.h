@@ -0,0 +1,199 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief Fixed-bucket histogram that can be updated from any thread without locking.
+     * Bucket bounds are in seconds, matching Prometheus conventions.
+     */
+    class histogram {
+    public:
+        /** Upper bounds of the finite buckets, the last bucket is +Inf */
+        static constexpr std::array<double, 10> bounds = { 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0 };
+
+        /**
+         * @brief Record one observation
+         *
+         * @param seconds Observed value in seconds
+         */
+        void observe( double seconds );
+
+        /**
+         * @brief Append this histogram in Prometheus text format
+         *
+         * @param out Buffer to append to
+         * @param name Metric name, without the _bucket/_sum/_count suffix
+         * @param labels Extra labels, e.g. `shard="0"`, may be empty
+         */
+        void render( std::string &out, const char *name, const std::string &labels ) const;
+
+    private:
+        std::array<std::atomic<uint64_t>, bounds.size() + 1> buckets{};
+        std::atomic<uint64_t> sum_us{ 0 };
+        std::atomic<uint64_t> count{ 0 };
+    };
+
+    /** @brief Caches whose lookups are counted by metrics */
+    enum cache_kind : uint8_t {
+        ck_user,
+        ck_guild,
+        ck_channel,
+        ck_role,
+        ck_emoji,
+        ck_count
+    };
+
+    /**
+     * @brief Shard, cache and REST statistics for the bot, optionally served as
+     * Prometheus text on a localhost HTTP endpoint.
+     *
+     * Counters are relaxed atomics bumped from the shard and REST threads; the
+     * gauges exposed by D++ itself (bytes, queue depth, cache sizes) are only
+     * read when the endpoint is scraped, so leaving collection enabled costs
+     * one atomic increment per event.
+     */
+    class metrics {
+    public:
+        /** Shards beyond this id share the last counter slot */
+        static constexpr size_t max_shards = 64;
+
+        /**
+         * @brief Construct a new metrics object
+         *
+         * @param bot Cluster to read shard and cache gauges from
+         */
+        explicit metrics( dpp::cluster &bot );
+
+        /**
+         * @brief Stops the HTTP endpoint if it is running
+         */
+        ~metrics();
+
+        /**
+         * @brief Count one dispatched event against the shard it arrived on.
+         * Only events the bot registers a handler for (and calls this from) are
+         * counted, not every gateway event the shard receives.
+         *
+         * @param event Any dispatched event
+         */
+        void count_event( const dpp::event_dispatch_t &event );
+
+        /**
+         * @brief Shards that have dispatched a counted event, ordered by id.
+         * Learned from the events themselves rather than cluster::get_shards(),
+         * which cluster::start is still filling while earlier shards already run.
+         * Shards with ids past max_shards are not listed.
+         *
+         * @return std::vector<std::pair<uint32_t, dpp::discord_client *>> Shard ids and their clients
+         */
+        std::vector<std::pair<uint32_t, dpp::discord_client *>> shards() const;
+
+        /**
+         * @brief Record a heartbeat ACK round-trip time for a shard
+         *
+         * @param shard_id Shard the ACK arrived on
+         * @param seconds Round-trip time in seconds
+         */
+        void observe_heartbeat( uint32_t shard_id, double seconds );
+
+        /**
+         * @brief Count a shard that stopped acknowledging heartbeats
+         *
+         * @param shard_id Shard that was detected as a zombie connection
+         */
+        void count_zombie( uint32_t shard_id );
+
+        /**
+         * @brief Count a cache lookup
+         *
+         * @param kind Cache that was queried
+         * @param hit True if the object was found
+         */
+        void count_cache_lookup( cache_kind kind, bool hit );
+
+        /** @brief dpp::find_user, counted as a cache lookup */
+        dpp::user *find_user( dpp::snowflake id );
+
+        /** @brief dpp::find_guild, counted as a cache lookup */
+        dpp::guild *find_guild( dpp::snowflake id );
+
+        /** @brief dpp::find_channel, counted as a cache lookup */
+        dpp::channel *find_channel( dpp::snowflake id );
+
+        /** @brief dpp::find_role, counted as a cache lookup */
+        dpp::role *find_role( dpp::snowflake id );
+
+        /**
+         * @brief Record the latency of a completed REST call
+         *
+         * @param cc Completion passed to a command_completion_event_t
+         */
+        void observe_rest( const dpp::confirmation_callback_t &cc );
+
+        /**
+         * @brief Wrap a REST completion callback so the call's latency is recorded
+         *
+         * @param callback Callback to run afterwards, may be empty
+         * @return dpp::command_completion_event_t Callback to pass to the cluster
+         */
+        dpp::command_completion_event_t timed( dpp::command_completion_event_t callback = {} );
+
+        /**
+         * @brief Add a callback that appends further metrics to every scrape.
+         * Register collectors before calling listen(); they run on the endpoint thread.
+         *
+         * @param collector Appends Prometheus text to the buffer it is given
+         */
+        void add_collector( std::function<void( std::string & )> collector );
+
+        /**
+         * @brief Render all metrics in Prometheus text exposition format
+         *
+         * @return std::string Response body for a scrape
+         */
+        std::string render() const;
+
+        /**
+         * @brief Start serving render() at http://127.0.0.1:port/metrics on a background thread
+         *
+         * @param port TCP port to listen on
+         * @return bool False if the socket could not be bound
+         */
+        bool listen( uint16_t port );
+
+        /**
+         * @brief Stop the HTTP endpoint and join its thread
+         */
+        void stop();
+
+    private:
+        static size_t slot( uint32_t shard_id );
+
+        void serve();
+
+        dpp::cluster &bot;
+        std::array<std::atomic<dpp::discord_client *>, max_shards> clients{};
+        std::array<std::atomic<uint64_t>, max_shards> events{};
+        std::array<std::atomic<uint64_t>, max_shards> zombies{};
+        std::array<histogram, max_shards> heartbeat_rtt;
+        std::array<std::atomic<uint64_t>, ck_count> cache_hits{};
+        std::array<std::atomic<uint64_t>, ck_count> cache_misses{};
+        std::atomic<uint64_t> rest_errors{ 0 };
+        histogram rest_latency;
+        std::vector<std::function<void( std::string & )>> collectors;
+
+        std::atomic<bool> running{ false };
+        SOCKET listener;
+        std::thread server;
+    };
+
+} // namespace mybot
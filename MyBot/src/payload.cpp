@@ -0,0 +1,291 @@
+#include "payload.h"
+#include "timestamp.h"
+#include <cctype>
+
+namespace mybot {
+
+    namespace {
+        /* Same as dpp::url_encode, which the D++ DLL does not export */
+        std::string url_encode( const std::string &value ) {
+            static constexpr char hex[] = "0123456789ABCDEF";
+            std::string out;
+            out.reserve( value.size() );
+            for ( unsigned char c : value ) {
+                if ( std::isalnum( c ) || c == '-' || c == '_' || c == '.' || c == '~' ) {
+                    out += static_cast<char>( c );
+                }
+                else {
+                    out += '%';
+                    out += hex[c >> 4];
+                    out += hex[c & 15];
+                }
+            }
+            return out;
+        }
+
+        void write_timestamp( json_writer &w, time_t t ) {
+            char buffer[iso8601_length];
+            w.value( format_iso8601( static_cast<int64_t>( t ) * 1000, buffer ) );
+        }
+
+        void write_emoji( json_writer &w, const std::string &name, dpp::snowflake id, bool animated ) {
+            if ( name.empty() && id == 0 ) {
+                return;
+            }
+            w.key( "emoji" ).begin_object();
+            if ( !name.empty() ) {
+                w.member( "name", std::string_view( name ) );
+            }
+            if ( id ) {
+                w.key( "id" ).snowflake( id );
+            }
+            w.member( "animated", animated );
+            w.end_object();
+        }
+
+        void write_image( json_writer &w, const char *name, const std::optional<dpp::embed_image> &image ) {
+            if ( image ) {
+                w.key( name ).begin_object().member( "url", std::string_view( image->url ) ).end_object();
+            }
+        }
+    } // namespace
+
+    void write_component( json_writer &w, const dpp::component &c ) {
+        w.begin_object();
+        w.member( "type", static_cast<uint32_t>( c.type ) );
+        switch ( c.type ) {
+        case dpp::cot_action_row:
+            w.key( "components" ).begin_array();
+            for ( const auto &child : c.components ) {
+                write_component( w, child );
+            }
+            w.end_array();
+            break;
+
+        case dpp::cot_button:
+            w.member( "label", std::string_view( c.label ) );
+            w.member( "style", static_cast<uint32_t>( c.style ) );
+            if ( c.style == dpp::cos_link ) {
+                w.member( "url", std::string_view( c.url ) );
+            }
+            else {
+                w.member( "custom_id", std::string_view( c.custom_id ) );
+            }
+            w.member( "disabled", c.disabled );
+            write_emoji( w, c.emoji.name, c.emoji.id, c.emoji.animated );
+            break;
+
+        case dpp::cot_selectmenu:
+            w.member( "custom_id", std::string_view( c.custom_id ) );
+            if ( !c.placeholder.empty() ) {
+                w.member( "placeholder", std::string_view( c.placeholder ) );
+            }
+            if ( c.min_values >= 0 ) {
+                w.member( "min_values", c.min_values );
+            }
+            if ( c.max_values >= 0 ) {
+                w.member( "max_values", c.max_values );
+            }
+            w.key( "options" ).begin_array();
+            for ( const auto &o : c.options ) {
+                w.begin_object();
+                w.member( "label", std::string_view( o.label ) );
+                w.member( "value", std::string_view( o.value ) );
+                if ( !o.description.empty() ) {
+                    w.member( "description", std::string_view( o.description ) );
+                }
+                w.member( "default", o.is_default );
+                write_emoji( w, o.emoji.name, o.emoji.id, o.emoji.animated );
+                w.end_object();
+            }
+            w.end_array();
+            w.member( "disabled", c.disabled );
+            break;
+        }
+        w.end_object();
+    }
+
+    void write_embed( json_writer &w, const dpp::embed &e ) {
+        w.begin_object();
+        if ( !e.title.empty() ) {
+            w.member( "title", std::string_view( e.title ) );
+        }
+        w.member( "type", e.type.empty() ? std::string_view( "rich" ) : std::string_view( e.type ) );
+        if ( !e.description.empty() ) {
+            w.member( "description", std::string_view( e.description ) );
+        }
+        if ( !e.url.empty() ) {
+            w.member( "url", std::string_view( e.url ) );
+        }
+        if ( e.timestamp ) {
+            w.key( "timestamp" );
+            write_timestamp( w, e.timestamp );
+        }
+        if ( e.color ) {
+            w.member( "color", e.color );
+        }
+        if ( e.footer ) {
+            w.key( "footer" ).begin_object().member( "text", std::string_view( e.footer->text ) );
+            if ( !e.footer->icon_url.empty() ) {
+                w.member( "icon_url", std::string_view( e.footer->icon_url ) );
+            }
+            w.end_object();
+        }
+        write_image( w, "image", e.image );
+        write_image( w, "thumbnail", e.thumbnail );
+        write_image( w, "video", e.video );
+        if ( e.author ) {
+            w.key( "author" ).begin_object().member( "name", std::string_view( e.author->name ) );
+            if ( !e.author->url.empty() ) {
+                w.member( "url", std::string_view( e.author->url ) );
+            }
+            if ( !e.author->icon_url.empty() ) {
+                w.member( "icon_url", std::string_view( e.author->icon_url ) );
+            }
+            w.end_object();
+        }
+        if ( !e.fields.empty() ) {
+            w.key( "fields" ).begin_array();
+            for ( const auto &f : e.fields ) {
+                w.begin_object();
+                w.member( "name", std::string_view( f.name ) );
+                w.member( "value", std::string_view( f.value ) );
+                w.member( "inline", f.is_inline );
+                w.end_object();
+            }
+            w.end_array();
+        }
+        w.end_object();
+    }
+
+    void write_message( json_writer &w, const dpp::message &m, bool is_interaction_response ) {
+        w.begin_object();
+        if ( !is_interaction_response ) {
+            w.key( "channel_id" ).snowflake( m.channel_id );
+        }
+        w.member( "content", std::string_view( m.content ) );
+        w.member( "tts", m.tts );
+        w.member( "flags", static_cast<uint32_t>( m.flags ) );
+        if ( !m.nonce.empty() ) {
+            w.member( "nonce", std::string_view( m.nonce ) );
+        }
+
+        if ( m.message_reference.message_id ) {
+            w.key( "message_reference" ).begin_object();
+            w.key( "message_id" ).snowflake( m.message_reference.message_id );
+            if ( m.message_reference.channel_id ) {
+                w.key( "channel_id" ).snowflake( m.message_reference.channel_id );
+            }
+            if ( m.message_reference.guild_id ) {
+                w.key( "guild_id" ).snowflake( m.message_reference.guild_id );
+            }
+            w.member( "fail_if_not_exists", m.message_reference.fail_if_not_exists );
+            w.end_object();
+        }
+
+        /* Only restrict mentions when the message asks for it, otherwise Discord's default applies */
+        const auto &am = m.allowed_mentions;
+        if ( am.parse_users || am.parse_roles || am.parse_everyone || am.replied_user || !am.users.empty() || !am.roles.empty() ) {
+            w.key( "allowed_mentions" ).begin_object();
+            w.key( "parse" ).begin_array();
+            if ( am.parse_users ) {
+                w.value( "users" );
+            }
+            if ( am.parse_roles ) {
+                w.value( "roles" );
+            }
+            if ( am.parse_everyone ) {
+                w.value( "everyone" );
+            }
+            w.end_array();
+            w.member( "replied_user", am.replied_user );
+            if ( !am.users.empty() ) {
+                w.key( "users" ).begin_array();
+                for ( dpp::snowflake id : am.users ) {
+                    w.snowflake( id );
+                }
+                w.end_array();
+            }
+            if ( !am.roles.empty() ) {
+                w.key( "roles" ).begin_array();
+                for ( dpp::snowflake id : am.roles ) {
+                    w.snowflake( id );
+                }
+                w.end_array();
+            }
+            w.end_object();
+        }
+
+        if ( !m.components.empty() ) {
+            w.key( "components" ).begin_array();
+            for ( const auto &c : m.components ) {
+                write_component( w, c );
+            }
+            w.end_array();
+        }
+
+        if ( !m.embeds.empty() ) {
+            w.key( "embeds" ).begin_array();
+            for ( const auto &e : m.embeds ) {
+                write_embed( w, e );
+            }
+            w.end_array();
+        }
+        w.end_object();
+    }
+
+    payload_sender::payload_sender( dpp::cluster &bot ) : bot( bot ) {}
+
+    void payload_sender::message_create( const dpp::message &m, dpp::command_completion_event_t callback ) {
+        thread_local std::string buffer;
+        buffer.clear();
+        json_writer w( buffer );
+        write_message( w, m );
+
+        bot.post_rest( API_PATH "/channels", std::to_string( m.channel_id ), "messages", dpp::m_post, buffer,
+                       [callback]( json &j, const dpp::http_request_completion_t &http ) {
+                           if ( callback ) {
+                               callback( dpp::confirmation_callback_t( "message", dpp::message().fill_from_json( &j ), http ) );
+                           }
+                       },
+                       m.filename, m.filecontent );
+    }
+
+    void payload_sender::interaction_reply( const dpp::interaction_create_t &event, dpp::interaction_response_type t, const dpp::message &m, dpp::command_completion_event_t callback ) {
+        thread_local std::string buffer;
+        buffer.clear();
+        json_writer w( buffer );
+        w.begin_object();
+        w.member( "type", static_cast<uint32_t>( t ) );
+        w.key( "data" );
+        write_message( w, m, true );
+        w.end_object();
+        post_interaction_reply( event, buffer, callback, m.filename, m.filecontent );
+    }
+
+    void payload_sender::interaction_reply( const dpp::interaction_create_t &event, dpp::interaction_response_type t, std::string_view content, dpp::command_completion_event_t callback ) {
+        thread_local std::string buffer;
+        buffer.clear();
+        json_writer w( buffer );
+        w.begin_object();
+        w.member( "type", static_cast<uint32_t>( t ) );
+        w.key( "data" ).begin_object();
+        w.member( "content", content );
+        w.member( "tts", false );
+        w.member( "flags", static_cast<uint32_t>( 0 ) );
+        w.end_object();
+        w.end_object();
+        post_interaction_reply( event, buffer, callback );
+    }
+
+    void payload_sender::post_interaction_reply( const dpp::interaction_create_t &event, const std::string &payload, dpp::command_completion_event_t callback, const std::string &filename, const std::string &filecontent ) {
+        bot.post_rest( API_PATH "/interactions", std::to_string( event.command.id ), url_encode( event.command.token ) + "/callback", dpp::m_post, payload,
+                       [callback]( json &, const dpp::http_request_completion_t &http ) {
+                           if ( callback ) {
+                               callback( dpp::confirmation_callback_t( "confirmation", dpp::confirmation{ true }, http ) );
+                           }
+                       },
+                       filename, filecontent );
+    }
+
+} // namespace mybot
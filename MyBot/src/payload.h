@@ -0,0 +1,78 @@
+#pragma once
+#include <dpp/dpp.h>
+#include "json_writer.h"
+#include <string>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief Write a component (action row, button or select menu) with the same
+     * fields as dpp::component::build_json()
+     */
+    void write_component( json_writer &w, const dpp::component &c );
+
+    /**
+     * @brief Write an embed with the same fields as D++ sends for dpp::embed
+     */
+    void write_embed( json_writer &w, const dpp::embed &e );
+
+    /**
+     * @brief Write a message with the same fields as dpp::message::build_json()
+     *
+     * @param w Writer to append to
+     * @param m Message to serialize
+     * @param is_interaction_response True to omit the channel id, as for interaction replies
+     */
+    void write_message( json_writer &w, const dpp::message &m, bool is_interaction_response = false );
+
+    /**
+     * @brief Sends messages and interaction replies from payloads serialized
+     * straight into a per-thread buffer, bypassing the nlohmann::json tree that
+     * dpp::message::build_json() builds and dumps on every send.
+     */
+    class payload_sender {
+    public:
+        /**
+         * @brief Construct a new payload sender
+         *
+         * @param bot Cluster whose REST queue the payloads are posted to
+         */
+        explicit payload_sender( dpp::cluster &bot );
+
+        /**
+         * @brief Equivalent of dpp::cluster::message_create()
+         *
+         * @param m Message to send, m.channel_id must be set
+         * @param callback On success confirmation_callback_t::value holds the created dpp::message
+         */
+        void message_create( const dpp::message &m, dpp::command_completion_event_t callback = {} );
+
+        /**
+         * @brief Equivalent of dpp::interaction_create_t::reply()
+         *
+         * @param event Interaction to reply to
+         * @param t Type of reply
+         * @param m Message to reply with
+         * @param callback On success confirmation_callback_t::value holds a dpp::confirmation
+         */
+        void interaction_reply( const dpp::interaction_create_t &event, dpp::interaction_response_type t, const dpp::message &m, dpp::command_completion_event_t callback = {} );
+
+        /**
+         * @brief Reply to an interaction with text only, without building a dpp::message,
+         * e.g. with the output of a reply_template
+         *
+         * @param event Interaction to reply to
+         * @param t Type of reply
+         * @param content Message content
+         * @param callback On success confirmation_callback_t::value holds a dpp::confirmation
+         */
+        void interaction_reply( const dpp::interaction_create_t &event, dpp::interaction_response_type t, std::string_view content, dpp::command_completion_event_t callback = {} );
+
+    private:
+        void post_interaction_reply( const dpp::interaction_create_t &event, const std::string &payload, dpp::command_completion_event_t callback, const std::string &filename = {}, const std::string &filecontent = {} );
+
+        dpp::cluster &bot;
+    };
+
+} // namespace mybot
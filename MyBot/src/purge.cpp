@@ -0,0 +1,218 @@
+#include "purge.h"
+#include <algorithm>
+#include <chrono>
+#include <future>
+
+namespace mybot {
+
+    namespace {
+        /** Most ids message_delete_bulk accepts, and most messages messages_get returns */
+        constexpr size_t page_size = 100;
+        /** Discord epoch, the first second of 2015, in Unix milliseconds */
+        constexpr uint64_t discord_epoch_ms = 1420070400000ull;
+        /** Bulk deletes reject messages older than two weeks; keep an hour's margin for long purges */
+        constexpr uint64_t bulk_max_age_ms = ( 14 * 24 - 1 ) * 3600 * 1000ull;
+        /** A REST callback that has not fired by then is treated as a failed request */
+        constexpr auto request_timeout = std::chrono::seconds( 60 );
+
+        /* Smallest id a message can have and still be bulk deleted */
+        dpp::snowflake oldest_bulk_id() {
+            uint64_t now = static_cast<uint64_t>( std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count() );
+            return ( now - bulk_max_age_ms - discord_epoch_ms ) << 22;
+        }
+    } // namespace
+
+    purger::purger( dpp::cluster &bot ) : bot( bot ) {}
+
+    purger::~purger() {
+        std::lock_guard<std::mutex> guard( lock );
+        for ( auto &j : jobs ) {
+            j.second->cancelled = true;
+        }
+        for ( auto &j : jobs ) {
+            j.second->worker.join();
+        }
+    }
+
+    bool purger::start( purge_request request ) {
+        std::lock_guard<std::mutex> guard( lock );
+        for ( auto it = jobs.begin(); it != jobs.end(); ) {
+            if ( it->second->finished ) {
+                it->second->worker.join();
+                it = jobs.erase( it );
+            }
+            else {
+                ++it;
+            }
+        }
+
+        std::unique_ptr<job> &slot = jobs[request.channel_id];
+        if ( slot ) {
+            return false;
+        }
+        slot = std::make_unique<job>();
+        job &j = *slot;
+        j.worker = std::thread( [this, &j, request = std::move( request )]() {
+            run( j, request );
+            j.finished = true;
+        } );
+        return true;
+    }
+
+    void purger::cancel( dpp::snowflake channel_id ) {
+        std::lock_guard<std::mutex> guard( lock );
+        auto it = jobs.find( channel_id );
+        if ( it != jobs.end() ) {
+            it->second->cancelled = true;
+        }
+    }
+
+    void purger::pause( job &j, uint64_t seconds ) {
+        /* Short steps so a cancel or shutdown is not held up by a long reset */
+        for ( uint64_t step = 0; step < seconds * 10 && !j.cancelled; ++step ) {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+        }
+    }
+
+    bool purger::call( job &j, const std::function<void( dpp::command_completion_event_t )> &send, dpp::confirmation_callback_t &cc ) {
+        for ( ;; ) {
+            /* The promise is shared with the callback, so a reply arriving after we gave up is harmless */
+            auto reply = std::make_shared<std::promise<dpp::confirmation_callback_t>>();
+            std::future<dpp::confirmation_callback_t> result = reply->get_future();
+            send( [reply]( const dpp::confirmation_callback_t &completion ) {
+                reply->set_value( completion );
+            } );
+            /* Wait in short steps so a cancel or shutdown does not sit out the whole timeout */
+            const auto deadline = std::chrono::steady_clock::now() + request_timeout;
+            while ( result.wait_for( std::chrono::milliseconds( 100 ) ) != std::future_status::ready ) {
+                if ( j.cancelled || std::chrono::steady_clock::now() >= deadline ) {
+                    return false;
+                }
+            }
+            cc = result.get();
+
+            const auto &http = cc.http_info;
+            if ( http.status == 429 && !j.cancelled ) {
+                pause( j, std::max<uint64_t>( http.ratelimit_retry_after, 1 ) );
+                continue;
+            }
+            /* Out of requests in this bucket: wait here rather than queueing behind the limit */
+            if ( http.ratelimit_limit && !http.ratelimit_remaining ) {
+                pause( j, http.ratelimit_reset_after );
+            }
+            return true;
+        }
+    }
+
+    bool purger::fetch_page( job &j, dpp::snowflake channel_id, dpp::snowflake before, std::vector<cached_message> &out ) {
+        out.clear();
+        dpp::confirmation_callback_t cc;
+        bool replied = call(
+            j, [&]( dpp::command_completion_event_t done ) {
+                bot.messages_get( channel_id, 0, before, 0, page_size, done );
+            },
+            cc );
+        if ( !replied || cc.is_error() ) {
+            return false;
+        }
+        const auto &messages = std::get<dpp::message_map>( cc.value );
+        out.reserve( messages.size() );
+        for ( const auto &m : messages ) {
+            out.push_back( { m.second.id, m.second.author ? m.second.author->id : 0, m.second.content } );
+        }
+        std::sort( out.begin(), out.end(), []( const cached_message &a, const cached_message &b ) {
+            return a.id > b.id;
+        } );
+        return messages.size() == page_size;
+    }
+
+    void purger::delete_batch( job &j, dpp::snowflake channel_id, std::vector<dpp::snowflake> &batch, purge_progress &progress ) {
+        if ( batch.empty() ) {
+            return;
+        }
+        /* The bulk endpoint wants at least two ids */
+        dpp::confirmation_callback_t cc;
+        bool replied = call(
+            j, [&]( dpp::command_completion_event_t done ) {
+                if ( batch.size() == 1 ) {
+                    bot.message_delete( batch[0], channel_id, done );
+                }
+                else {
+                    bot.message_delete_bulk( batch, channel_id, done );
+                }
+            },
+            cc );
+        ( !replied || cc.is_error() ? progress.failed : progress.deleted ) += batch.size();
+        batch.clear();
+    }
+
+    void purger::run( job &j, const purge_request &request ) {
+        purge_progress progress;
+        progress.channel_id = request.channel_id;
+        auto report = [&]() {
+            if ( request.progress ) {
+                request.progress( progress );
+            }
+        };
+
+        const dpp::snowflake oldest_bulk = oldest_bulk_id();
+        std::vector<dpp::snowflake> batch;
+        batch.reserve( page_size );
+        /* A cancelled purge stops deleting, including whatever is still batched */
+        auto flush = [&]() {
+            if ( !batch.empty() && !j.cancelled ) {
+                delete_batch( j, request.channel_id, batch, progress );
+                report();
+            }
+        };
+
+        std::vector<cached_message> page;
+        bool more = false;
+        if ( request.cache ) {
+            request.cache->collect( request.channel_id, page );
+        }
+        else {
+            more = fetch_page( j, request.channel_id, request.before, page );
+        }
+
+        bool stop = false;
+        while ( !stop ) {
+            for ( const cached_message &m : page ) {
+                if ( j.cancelled || progress.scanned == request.scan_limit || progress.matched == request.limit ) {
+                    stop = true;
+                    break;
+                }
+                if ( request.before && m.id >= request.before ) {
+                    continue;
+                }
+                ++progress.scanned;
+                if ( request.filter && !request.filter( m ) ) {
+                    continue;
+                }
+                ++progress.matched;
+                if ( m.id >= oldest_bulk ) {
+                    batch.push_back( m.id );
+                    if ( batch.size() == page_size ) {
+                        flush();
+                    }
+                }
+                else {
+                    /* Pages are newest first, so everything from here on is deleted singly */
+                    flush();
+                    batch.push_back( m.id );
+                    flush();
+                }
+            }
+            if ( stop || !more || page.empty() ) {
+                break;
+            }
+            more = fetch_page( j, request.channel_id, page.back().id, page );
+        }
+        flush();
+
+        progress.done = true;
+        progress.cancelled = j.cancelled;
+        report();
+    }
+
+} // namespace mybot
@@ -0,0 +1,113 @@
+#pragma once
+#include <dpp/dpp.h>
+#include "message_cache.h"
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief Running totals of a purge, passed to purge_request::progress
+     */
+    struct purge_progress {
+        dpp::snowflake channel_id = 0;
+        /** Messages read from history or the cache */
+        size_t scanned = 0;
+        /** Messages the filter accepted */
+        size_t matched = 0;
+        /** Messages Discord confirmed deleted */
+        size_t deleted = 0;
+        /** Messages whose delete request failed */
+        size_t failed = 0;
+        /** Set on the final report */
+        bool done = false;
+        /** Set on the final report if purger::cancel stopped the purge early */
+        bool cancelled = false;
+    };
+
+    /**
+     * @brief What to delete, and where to report progress
+     */
+    struct purge_request {
+        dpp::snowflake channel_id = 0;
+        /** Only messages older than this id are considered; 0 starts from the newest */
+        dpp::snowflake before = 0;
+        /** Stop after this many messages have matched */
+        size_t limit = 100;
+        /** Stop after reading this many messages, matched or not */
+        size_t scan_limit = 1000;
+        /** Chooses the messages to delete; everything when empty */
+        std::function<bool( const cached_message & )> filter;
+        /** Called after each delete request and once more when finished, on the purge thread */
+        std::function<void( const purge_progress & )> progress;
+        /** Read candidates from this cache instead of the channel history. Must outlive the purge. */
+        const message_cache *cache = nullptr;
+    };
+
+    /**
+     * @brief Deletes messages matching a filter, using as few requests as Discord allows.
+     *
+     * Candidates are streamed newest first, a page of 100 at a time from the
+     * channel history (or all at once from a message_cache). Matches younger
+     * than 14 days are deleted in bulk batches of up to 100; older ones, which
+     * the bulk endpoint rejects, one by one. Each purge runs on its own thread
+     * with one request in flight: when the channel's bucket reports no requests
+     * remaining the thread waits for it to reset, and a 429 is waited out and
+     * retried, so a large purge never floods the shared REST queue. A request
+     * with no reply within a minute counts as failed.
+     */
+    class purger {
+    public:
+        /**
+         * @brief Construct a new purger
+         *
+         * @param bot Cluster to make the requests with
+         */
+        explicit purger( dpp::cluster &bot );
+
+        /**
+         * @brief Cancels running purges and waits for them to stop
+         */
+        ~purger();
+
+        purger( const purger & ) = delete;
+        purger &operator=( const purger & ) = delete;
+
+        /**
+         * @brief Start purging a channel in the background
+         *
+         * @param request What to delete
+         * @return bool False if the channel is already being purged
+         */
+        bool start( purge_request request );
+
+        /**
+         * @brief Stop a channel's purge after the request in flight
+         */
+        void cancel( dpp::snowflake channel_id );
+
+    private:
+        struct job {
+            std::thread worker;
+            std::atomic<bool> cancelled{ false };
+            std::atomic<bool> finished{ false };
+        };
+
+        void run( job &j, const purge_request &request );
+        bool fetch_page( job &j, dpp::snowflake channel_id, dpp::snowflake before, std::vector<cached_message> &out );
+        void delete_batch( job &j, dpp::snowflake channel_id, std::vector<dpp::snowflake> &batch, purge_progress &progress );
+        bool call( job &j, const std::function<void( dpp::command_completion_event_t )> &send, dpp::confirmation_callback_t &cc );
+        void pause( job &j, uint64_t seconds );
+
+        dpp::cluster &bot;
+        std::mutex lock;
+        std::unordered_map<dpp::snowflake, std::unique_ptr<job>> jobs;
+    };
+
+} // namespace mybot
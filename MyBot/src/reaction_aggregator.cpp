@@ -0,0 +1,208 @@
+#include "reaction_aggregator.h"
+#include <algorithm>
+#include <utility>
+
+namespace mybot {
+
+    namespace {
+        /* Unicode emojis have no id, so they are told apart by name */
+        std::string emoji_key_name( dpp::snowflake emoji_id, const std::string &name ) {
+            return emoji_id ? std::string() : name;
+        }
+    } // namespace
+
+    size_t reaction_aggregator::key_hash::operator()( const key &k ) const {
+        size_t h = std::hash<uint64_t>()( k.message_id );
+        h ^= std::hash<uint64_t>()( k.emoji_id ) + 0x9e3779b97f4a7c15ull + ( h << 6 ) + ( h >> 2 );
+        h ^= std::hash<std::string>()( k.emoji_name ) + 0x9e3779b97f4a7c15ull + ( h << 6 ) + ( h >> 2 );
+        return h;
+    }
+
+    reaction_aggregator::reaction_aggregator( handler_t handler, std::chrono::milliseconds interval, std::chrono::seconds idle )
+        : handler( std::move( handler ) ), interval( interval ), idle( idle ) {}
+
+    reaction_aggregator::~reaction_aggregator() {
+        stop();
+    }
+
+    void reaction_aggregator::start() {
+        if ( running.exchange( true ) ) {
+            return;
+        }
+        deliverer = std::thread( &reaction_aggregator::run, this );
+    }
+
+    void reaction_aggregator::stop() {
+        if ( !running.exchange( false ) ) {
+            return;
+        }
+        if ( deliverer.joinable() ) {
+            deliverer.join();
+        }
+        flush();
+    }
+
+    void reaction_aggregator::run() {
+        while ( running ) {
+            std::this_thread::sleep_for( interval );
+            flush();
+        }
+    }
+
+    reaction_aggregator::stripe &reaction_aggregator::stripe_for( const key &k ) {
+        /* The low bits pick the bucket inside the stripe's map, so use the high bits here */
+        return stripes[( key_hash()( k ) >> 16 ) % stripe_count];
+    }
+
+    void reaction_aggregator::record( const dpp::channel *channel, dpp::snowflake message_id, const dpp::emoji *emoji, const dpp::user *user, bool add ) {
+        if ( !emoji || !user ) {
+            return;
+        }
+        key k{ message_id, emoji->id, emoji_key_name( emoji->id, emoji->name ) };
+        stripe &s = stripe_for( k );
+        std::lock_guard<std::mutex> guard( s.lock );
+        tally &t = s.tallies[k];
+        if ( t.emoji_name.empty() ) {
+            t.emoji_name = emoji->name;
+        }
+        if ( channel ) {
+            t.channel_id = channel->id;
+        }
+        t.last_event = std::chrono::steady_clock::now();
+        if ( add ) {
+            if ( t.users.insert( user->id ).second ) {
+                ++t.added;
+                ++t.total;
+            }
+        }
+        /* A user missing from the set still counts if the total includes reactions
+         * from before tracking started or from a reconcile */
+        else if ( t.users.erase( user->id ) || t.total > static_cast<int64_t>( t.users.size() ) ) {
+            ++t.removed;
+            --t.total;
+        }
+    }
+
+    void reaction_aggregator::on_reaction_add( const dpp::message_reaction_add_t &event ) {
+        record( event.reacting_channel, event.message_id, event.reacting_emoji, event.reacting_user, true );
+    }
+
+    void reaction_aggregator::on_reaction_remove( const dpp::message_reaction_remove_t &event ) {
+        record( event.reacting_channel, event.message_id, event.reacting_emoji, event.reacting_user, false );
+    }
+
+    void reaction_aggregator::clear( dpp::snowflake message_id, const dpp::emoji *emoji ) {
+        const auto now = std::chrono::steady_clock::now();
+        for ( stripe &s : stripes ) {
+            std::lock_guard<std::mutex> guard( s.lock );
+            for ( auto &entry : s.tallies ) {
+                const key &k = entry.first;
+                if ( k.message_id != message_id || ( emoji && ( k.emoji_id != emoji->id || k.emoji_name != emoji_key_name( emoji->id, emoji->name ) ) ) ) {
+                    continue;
+                }
+                tally &t = entry.second;
+                t.removed += t.total;
+                t.total = 0;
+                t.users.clear();
+                t.last_event = now;
+            }
+        }
+    }
+
+    void reaction_aggregator::on_reaction_remove_emoji( const dpp::message_reaction_remove_emoji_t &event ) {
+        if ( event.reacting_emoji ) {
+            clear( event.message_id, event.reacting_emoji );
+        }
+    }
+
+    void reaction_aggregator::on_reaction_remove_all( const dpp::message_reaction_remove_all_t &event ) {
+        clear( event.message_id, nullptr );
+    }
+
+    void reaction_aggregator::flush() {
+        std::vector<reaction_delta> deltas;
+        const auto now = std::chrono::steady_clock::now();
+        for ( stripe &s : stripes ) {
+            std::lock_guard<std::mutex> guard( s.lock );
+            for ( auto it = s.tallies.begin(); it != s.tallies.end(); ) {
+                tally &t = it->second;
+                if ( t.added || t.removed ) {
+                    deltas.push_back( { t.channel_id, it->first.message_id, it->first.emoji_id, t.emoji_name, t.added, t.removed, t.total } );
+                    t.added = t.removed = 0;
+                }
+                else if ( now - t.last_event > idle ) {
+                    it = s.tallies.erase( it );
+                    continue;
+                }
+                ++it;
+            }
+        }
+        if ( !deltas.empty() && handler ) {
+            handler( deltas );
+        }
+    }
+
+    void reaction_aggregator::set_total( const key &k, const std::string &emoji_name, dpp::snowflake channel_id, int64_t count ) {
+        stripe &s = stripe_for( k );
+        std::lock_guard<std::mutex> guard( s.lock );
+        auto it = s.tallies.find( k );
+        if ( it == s.tallies.end() ) {
+            if ( count == 0 ) {
+                return;
+            }
+            it = s.tallies.emplace( k, tally() ).first;
+            it->second.channel_id = channel_id;
+            it->second.emoji_name = emoji_name;
+            it->second.last_event = std::chrono::steady_clock::now();
+        }
+        tally &t = it->second;
+        if ( count > t.total ) {
+            t.added += count - t.total;
+        }
+        else {
+            t.removed += t.total - count;
+        }
+        t.total = count;
+        /* Who is behind the new total is unknown; a stale set would drop the add of a user
+         * who un-reacted during the outage and reacts again. Removes are still accepted
+         * while the total exceeds the set, see record(). */
+        t.users.clear();
+    }
+
+    void reaction_aggregator::reconcile( dpp::cluster &bot ) {
+        /* Snapshot what is tracked, per message, then ask Discord for each message once */
+        std::unordered_map<dpp::snowflake, std::pair<dpp::snowflake, std::vector<key>>> messages;
+        for ( stripe &s : stripes ) {
+            std::lock_guard<std::mutex> guard( s.lock );
+            for ( const auto &entry : s.tallies ) {
+                if ( entry.second.channel_id ) {
+                    auto &m = messages[entry.first.message_id];
+                    m.first = entry.second.channel_id;
+                    m.second.push_back( entry.first );
+                }
+            }
+        }
+
+        for ( auto &m : messages ) {
+            dpp::snowflake channel_id = m.second.first;
+            bot.message_get( m.first, channel_id, [this, channel_id, tracked = std::move( m.second.second )]( const dpp::confirmation_callback_t &cc ) {
+                if ( cc.is_error() ) {
+                    return;
+                }
+                const dpp::message &msg = std::get<dpp::message>( cc.value );
+                std::vector<key> seen;
+                for ( const dpp::reaction &r : msg.reactions ) {
+                    seen.push_back( { msg.id, r.emoji_id, emoji_key_name( r.emoji_id, r.emoji_name ) } );
+                    set_total( seen.back(), r.emoji_name, channel_id, r.count );
+                }
+                /* Reactions we were counting that are gone entirely */
+                for ( const key &k : tracked ) {
+                    if ( std::find( seen.begin(), seen.end(), k ) == seen.end() ) {
+                        set_total( k, k.emoji_name, channel_id, 0 );
+                    }
+                }
+            } );
+        }
+    }
+
+} // namespace mybot
@@ -0,0 +1,143 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief Net change in one reaction on one message since the previous delivery
+     */
+    struct reaction_delta {
+        /** Channel of the message, 0 if the channel was not cached when the reactions arrived */
+        dpp::snowflake channel_id = 0;
+        dpp::snowflake message_id = 0;
+        /** Custom emoji id, 0 for unicode emojis */
+        dpp::snowflake emoji_id = 0;
+        /** Emoji name, or the unicode emoji itself */
+        std::string emoji_name;
+        /** Users who reacted since the previous delivery */
+        int64_t added = 0;
+        /** Users who removed their reaction since the previous delivery */
+        int64_t removed = 0;
+        /** Current count */
+        int64_t total = 0;
+    };
+
+    /**
+     * @brief Coalesces reaction add and remove events per (message, emoji) and
+     * delivers the net changes in batches, so a poll or giveaway receiving
+     * thousands of clicks a second calls the handler once per interval instead
+     * of once per click.
+     *
+     * Each tally keeps the set of users currently counted, which drops
+     * duplicate adds (e.g. replayed after a resume) and removes for users who
+     * were never counted. Tallies are spread over lock stripes by key hash so
+     * busy messages do not contend with each other, and a tally that sees no
+     * events for the idle period is dropped.
+     */
+    class reaction_aggregator {
+    public:
+        using handler_t = std::function<void( const std::vector<reaction_delta> & )>;
+
+        /**
+         * @brief Construct a new reaction aggregator
+         *
+         * @param handler Receives each batch of deltas, on the aggregator's thread
+         * @param interval Time between deliveries
+         * @param idle Tallies without events for this long are forgotten
+         */
+        explicit reaction_aggregator( handler_t handler, std::chrono::milliseconds interval = std::chrono::seconds( 1 ), std::chrono::seconds idle = std::chrono::minutes( 15 ) );
+
+        /**
+         * @brief Stops the delivery thread
+         */
+        ~reaction_aggregator();
+
+        /**
+         * @brief Start delivering deltas on a background thread
+         */
+        void start();
+
+        /**
+         * @brief Deliver anything pending, then stop and join the background thread
+         */
+        void stop();
+
+        void on_reaction_add( const dpp::message_reaction_add_t &event );
+        void on_reaction_remove( const dpp::message_reaction_remove_t &event );
+        void on_reaction_remove_emoji( const dpp::message_reaction_remove_emoji_t &event );
+        void on_reaction_remove_all( const dpp::message_reaction_remove_all_t &event );
+
+        /**
+         * @brief Deliver pending deltas now
+         */
+        void flush();
+
+        /**
+         * @brief Re-read the counts of every tracked message over REST, e.g. after
+         * a reconnect in which events may have been lost. Differences are
+         * delivered as deltas with the next flush. The REST counts do not say
+         * who reacted, so a reconciled tally starts a fresh set of users.
+         *
+         * @param bot Cluster to make the requests with
+         */
+        void reconcile( dpp::cluster &bot );
+
+    private:
+        struct key {
+            dpp::snowflake message_id;
+            dpp::snowflake emoji_id;
+            std::string emoji_name;
+
+            bool operator==( const key &o ) const {
+                return message_id == o.message_id && emoji_id == o.emoji_id && emoji_name == o.emoji_name;
+            }
+        };
+
+        struct key_hash {
+            size_t operator()( const key &k ) const;
+        };
+
+        struct tally {
+            dpp::snowflake channel_id = 0;
+            /** Display name; the key leaves it empty for custom emojis, which are told apart by id */
+            std::string emoji_name;
+            std::unordered_set<dpp::snowflake> users;
+            int64_t total = 0;
+            int64_t added = 0;
+            int64_t removed = 0;
+            std::chrono::steady_clock::time_point last_event;
+        };
+
+        struct stripe {
+            std::mutex lock;
+            std::unordered_map<key, tally, key_hash> tallies;
+        };
+
+        static constexpr size_t stripe_count = 64;
+
+        stripe &stripe_for( const key &k );
+        void set_total( const key &k, const std::string &emoji_name, dpp::snowflake channel_id, int64_t count );
+        void record( const dpp::channel *channel, dpp::snowflake message_id, const dpp::emoji *emoji, const dpp::user *user, bool add );
+        void clear( dpp::snowflake message_id, const dpp::emoji *emoji );
+        void run();
+
+        handler_t handler;
+        const std::chrono::milliseconds interval;
+        const std::chrono::seconds idle;
+        std::array<stripe, stripe_count> stripes;
+        std::atomic<bool> running{ false };
+        std::thread deliverer;
+    };
+
+} // namespace mybot
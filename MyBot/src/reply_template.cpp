@@ -0,0 +1,78 @@
+#include "reply_template.h"
+#include <stdexcept>
+
+namespace mybot {
+
+    reply_template::reply_template( std::string_view pattern, std::initializer_list<std::string_view> names ) : arg_count( names.size() ) {
+        text.reserve( pattern.size() );
+
+        /* Extend the trailing literal segment, or start a new one */
+        auto literal = [this]( std::string_view s ) {
+            if ( segments.empty() || segments.back().arg >= 0 ) {
+                segments.push_back( { static_cast<uint32_t>( text.size() ), 0, -1 } );
+            }
+            text.append( s );
+            segments.back().length += static_cast<uint32_t>( s.size() );
+            literal_length += s.size();
+        };
+
+        size_t i = 0;
+        while ( i < pattern.size() ) {
+            size_t brace = pattern.find_first_of( "{}", i );
+            if ( brace == std::string_view::npos ) {
+                literal( pattern.substr( i ) );
+                break;
+            }
+            literal( pattern.substr( i, brace - i ) );
+
+            if ( brace + 1 < pattern.size() && pattern[brace + 1] == pattern[brace] ) {
+                literal( pattern.substr( brace, 1 ) );
+                i = brace + 2;
+                continue;
+            }
+            if ( pattern[brace] == '}' ) {
+                throw std::invalid_argument( "Unmatched '}' in reply template" );
+            }
+
+            size_t close = pattern.find( '}', brace );
+            if ( close == std::string_view::npos ) {
+                throw std::invalid_argument( "Unterminated placeholder in reply template" );
+            }
+            std::string_view name = pattern.substr( brace + 1, close - brace - 1 );
+            int32_t index = 0;
+            for ( std::string_view n : names ) {
+                if ( n == name ) {
+                    break;
+                }
+                ++index;
+            }
+            if ( static_cast<size_t>( index ) == names.size() ) {
+                throw std::invalid_argument( "Unknown placeholder '" + std::string( name ) + "' in reply template" );
+            }
+            segments.push_back( { 0, 0, index } );
+            i = close + 1;
+        }
+    }
+
+    void reply_template::append_args( std::string &out, const template_arg *args, size_t count ) const {
+        if ( count != arg_count ) {
+            throw std::invalid_argument( "Wrong number of arguments for reply template" );
+        }
+        size_t total = literal_length;
+        for ( const segment &s : segments ) {
+            if ( s.arg >= 0 ) {
+                total += args[s.arg].view().size();
+            }
+        }
+        out.reserve( out.size() + total );
+        for ( const segment &s : segments ) {
+            if ( s.arg >= 0 ) {
+                out.append( args[s.arg].view() );
+            }
+            else {
+                out.append( text, s.offset, s.length );
+            }
+        }
+    }
+
+} // namespace mybot
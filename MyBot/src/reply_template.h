@@ -0,0 +1,104 @@
+#pragma once
+#include <dpp/dpp.h>
+#include <dpp/fmt/compile.h>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace mybot {
+
+    /**
+     * @brief One value substituted into a reply_template. Strings are referenced,
+     * numbers are formatted into an inline buffer with a compiled fmt format, so
+     * neither allocates.
+     */
+    class template_arg {
+    public:
+        template_arg( std::string_view s ) : text( s ) {}
+        template_arg( const std::string &s ) : text( s ) {}
+        template_arg( const char *s ) : text( s ) {}
+
+        template <typename T, std::enable_if_t<std::is_arithmetic_v<T>, int> = 0> template_arg( T value ) {
+            auto result = fmt::format_to_n( digits, sizeof( digits ), FMT_COMPILE( "{}" ), value );
+            text = std::string_view( digits, result.size < sizeof( digits ) ? result.size : sizeof( digits ) );
+        }
+
+        /* text may point into digits, so a copy would dangle */
+        template_arg( const template_arg & ) = delete;
+        template_arg &operator=( const template_arg & ) = delete;
+
+        std::string_view view() const {
+            return text;
+        }
+
+    private:
+        char digits[32];
+        std::string_view text;
+    };
+
+    /**
+     * @brief A reply with named placeholders, parsed once and then rendered any
+     * number of times into a reusable buffer. Rendering is a sequence of appends
+     * of precomputed literal slices and argument views, with no format string
+     * parsing at run time.
+     *
+     * @code
+     * static const mybot::reply_template chose( "You clicked {id} and chose: {choice}", { "id", "choice" } );
+     * chose.render( buffer, event.custom_id, event.values[0] );
+     * @endcode
+     */
+    class reply_template {
+    public:
+        /**
+         * @brief Parse a template
+         *
+         * @param pattern Text with {name} placeholders; {{ and }} are literal braces
+         * @param names Placeholder names, in the order render() takes its arguments.
+         * A name may be used any number of times in the pattern, or not at all.
+         * @throws std::invalid_argument if a placeholder is unterminated or not in names
+         */
+        reply_template( std::string_view pattern, std::initializer_list<std::string_view> names );
+
+        /**
+         * @brief Append the rendered template to out
+         *
+         * @param out String to append to
+         * @param args One value per name, in the order given to the constructor
+         */
+        template <typename... Args> void append( std::string &out, const Args &...args ) const {
+            const std::array<template_arg, sizeof...( Args )> values{ template_arg( args )... };
+            append_args( out, values.data(), values.size() );
+        }
+
+        /**
+         * @brief Clear out, then render the template into it
+         *
+         * @return std::string_view View of out
+         */
+        template <typename... Args> std::string_view render( std::string &out, const Args &...args ) const {
+            out.clear();
+            append( out, args... );
+            return out;
+        }
+
+    private:
+        /** A literal slice of text, or one argument if arg >= 0 */
+        struct segment {
+            uint32_t offset;
+            uint32_t length;
+            int32_t arg;
+        };
+
+        void append_args( std::string &out, const template_arg *args, size_t count ) const;
+
+        std::string text;
+        std::vector<segment> segments;
+        size_t arg_count;
+        size_t literal_length = 0;
+    };
+
+} // namespace mybot
@@ -0,0 +1,112 @@
+#include "sanitize.h"
+#include "mentions.h"
+#include <array>
+
+namespace mybot {
+
+    namespace {
+        constexpr std::string_view zero_width_space = "\xE2\x80\x8B";
+
+        /* Bits in the character table; they match the sanitize_flags that enable them */
+        constexpr uint8_t class_markdown = sf_markdown;
+        constexpr uint8_t class_at = sf_everyone;
+
+        constexpr std::array<uint8_t, 256> make_table() {
+            std::array<uint8_t, 256> t{};
+            for ( char c : std::string_view( "\\*_~`|>#-[]" ) ) {
+                t[static_cast<unsigned char>( c )] = class_markdown;
+            }
+            t['@'] = class_at;
+            return t;
+        }
+
+        constexpr std::array<uint8_t, 256> char_class = make_table();
+
+        inline bool starts_with( std::string_view s, std::string_view prefix ) {
+            return s.substr( 0, prefix.size() ) == prefix;
+        }
+
+        inline bool is_mention( token_type t ) {
+            return t == tok_user || t == tok_role || t == tok_channel;
+        }
+
+        inline bool is_mass_mention( std::string_view after_at ) {
+            return starts_with( after_at, "everyone" ) || starts_with( after_at, "here" );
+        }
+
+        /* Copy a token verbatim except for @everyone and @here, which Discord still pings inside links */
+        void append_breaking_everyone( std::string &out, std::string_view text ) {
+            size_t run = 0;
+            for ( size_t at = text.find( '@' ); at != std::string_view::npos; at = text.find( '@', at + 1 ) ) {
+                if ( is_mass_mention( text.substr( at + 1 ) ) ) {
+                    out.append( text.data() + run, at + 1 - run );
+                    out.append( zero_width_space );
+                    run = at + 1;
+                }
+            }
+            out.append( text.data() + run, text.size() - run );
+        }
+    } // namespace
+
+    void append_sanitized( std::string &out, std::string_view in, uint32_t flags ) {
+        const uint8_t active = static_cast<uint8_t>( flags & ( sf_markdown | sf_everyone ) );
+        out.reserve( out.size() + in.size() + in.size() / 8 );
+
+        /* Emojis and links must survive escaping, and mentions may need breaking */
+        token_list tokens;
+        if ( flags & ( sf_markdown | sf_mentions ) ) {
+            tokens = scan_tokens( in );
+        }
+        size_t next = 0;
+        size_t token_at = tokens.empty() ? in.size() : static_cast<size_t>( tokens[0].text.data() - in.data() );
+
+        size_t run = 0;
+        size_t i = 0;
+        while ( i < in.size() ) {
+            if ( i == token_at ) {
+                out.append( in.data() + run, i - run );
+                const message_token &t = tokens[next];
+                if ( ( flags & sf_mentions ) && is_mention( t.type ) ) {
+                    out += '<';
+                    out.append( zero_width_space );
+                    out.append( t.text.substr( 1 ) );
+                }
+                else if ( flags & sf_everyone ) {
+                    append_breaking_everyone( out, t.text );
+                }
+                else {
+                    out.append( t.text );
+                }
+                i = run = i + t.text.size();
+                token_at = ++next < tokens.size() ? static_cast<size_t>( tokens[next].text.data() - in.data() ) : in.size();
+                continue;
+            }
+
+            const uint8_t cls = char_class[static_cast<unsigned char>( in[i] )] & active;
+            if ( cls == 0 ) {
+                ++i;
+                continue;
+            }
+            out.append( in.data() + run, i - run );
+            if ( cls == class_markdown ) {
+                out += '\\';
+                out += in[i];
+            }
+            else {
+                out += '@';
+                if ( is_mass_mention( in.substr( i + 1 ) ) ) {
+                    out.append( zero_width_space );
+                }
+            }
+            run = ++i;
+        }
+        out.append( in.data() + run, in.size() - run );
+    }
+
+    std::string_view sanitize( std::string_view in, std::string &buffer, uint32_t flags ) {
+        buffer.clear();
+        append_sanitized( buffer, in, flags );
+        return buffer;
+    }
+
+} // namespace mybot
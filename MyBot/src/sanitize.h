@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief What sanitize() neutralizes; combine with |
+     */
+    enum sanitize_flags : uint32_t {
+        /// Backslash-escape markdown control characters: \ * _ ~ ` | > # - [ ]
+        sf_markdown = 0x01,
+        /// Break @everyone and @here with a zero width space
+        sf_everyone = 0x02,
+        /// Break <@user>, <@!user>, <@&role> and <#channel> mentions with a zero width space
+        sf_mentions = 0x04,
+        /// All of the above
+        sf_all = sf_markdown | sf_everyone | sf_mentions,
+    };
+
+    /**
+     * @brief Append user-supplied text to out so it displays literally when echoed
+     * back. Characters are classified through a 256-entry table and unaffected runs
+     * are copied in bulk. Custom emojis and links are copied untouched so that
+     * escaping does not break them.
+     *
+     * @param out String to append to
+     * @param in Text to sanitize
+     * @param flags Combination of sanitize_flags
+     */
+    void append_sanitized( std::string &out, std::string_view in, uint32_t flags = sf_all );
+
+    /**
+     * @brief Sanitize into a caller-owned buffer that is reused between calls, so
+     * its capacity is only grown once.
+     *
+     * @param in Text to sanitize
+     * @param buffer Cleared, then receives the result
+     * @param flags Combination of sanitize_flags
+     * @return std::string_view View of buffer
+     */
+    std::string_view sanitize( std::string_view in, std::string &buffer, uint32_t flags = sf_all );
+
+} // namespace mybot
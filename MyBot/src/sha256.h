@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief Incremental SHA-256 (FIPS 180-4). D++ links OpenSSL internally but
+     * does not expose it, so this is here for signing component state.
+     */
+    class sha256 {
+    public:
+        /** Size of a digest in bytes */
+        static constexpr size_t digest_size = 32;
+        /** Size of the internal block in bytes */
+        static constexpr size_t block_size = 64;
+
+        sha256();
+
+        /**
+         * @brief Hash more data
+         */
+        sha256 &update( const void *data, size_t length );
+
+        sha256 &update( std::string_view s ) {
+            return update( s.data(), s.size() );
+        }
+
+        /**
+         * @brief Finish hashing and write the digest. The object must not be updated afterwards.
+         *
+         * @param out Receives digest_size bytes
+         */
+        void finish( uint8_t *out );
+
+    private:
+        void compress( const uint8_t *block );
+
+        uint32_t state[8];
+        uint8_t buffer[block_size];
+        uint64_t total = 0;
+        size_t used = 0;
+    };
+
+    /**
+     * @brief HMAC-SHA256 with the key schedule done once, for signing many short messages
+     */
+    class hmac_sha256 {
+    public:
+        /**
+         * @brief Prepare a key
+         *
+         * @param key Secret of any length
+         */
+        explicit hmac_sha256( std::string_view key );
+
+        /**
+         * @brief Compute the MAC of a message
+         *
+         * @param message Data to authenticate
+         * @param out Receives sha256::digest_size bytes
+         */
+        void sign( std::string_view message, uint8_t *out ) const;
+
+    private:
+        sha256 inner;
+        sha256 outer;
+    };
+
+} // namespace mybot
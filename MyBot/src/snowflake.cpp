@@ -0,0 +1,69 @@
+#include "snowflake.h"
+#include <cstdint>
+#include <cstring>
+
+namespace mybot {
+
+    namespace {
+        /* Eight ASCII bytes, first character in the lowest byte (little endian load) */
+        uint64_t load8( const char *p ) {
+            uint64_t v;
+            std::memcpy( &v, p, sizeof( v ) );
+            return v;
+        }
+
+        /* True if every byte is in '0'..'9': high nibble must be 3, and adding 6 must not carry into it */
+        bool all_digits( uint64_t v ) {
+            return ( ( v & 0xF0F0F0F0F0F0F0F0ull ) | ( ( ( v + 0x0606060606060606ull ) & 0xF0F0F0F0F0F0F0F0ull ) >> 4 ) ) == 0x3333333333333333ull;
+        }
+
+        /* Convert eight validated digits to their value by pairwise combining 1, 2 and 4 digit groups */
+        uint32_t eight_digits( uint64_t v ) {
+            v -= 0x3030303030303030ull;
+            v = ( v * 10 ) + ( v >> 8 );
+            v = ( ( ( v & 0x000000FF000000FFull ) * ( 100 + ( 1000000ull << 32 ) ) ) +
+                  ( ( ( v >> 16 ) & 0x000000FF000000FFull ) * ( 1 + ( 10000ull << 32 ) ) ) ) >> 32;
+            return static_cast<uint32_t>( v );
+        }
+
+        constexpr std::string_view max_u64 = "18446744073709551615";
+    } // namespace
+
+    bool parse_snowflake( std::string_view s, dpp::snowflake &out ) {
+        const size_t n = s.size();
+        if ( n == 0 || n > max_u64.size() || ( n == max_u64.size() && s > max_u64 ) ) {
+            return false;
+        }
+
+        const char *p = s.data();
+        uint64_t value = 0;
+
+        /* Leading digits that do not fill a whole word */
+        size_t head = n % 8;
+        for ( size_t i = 0; i < head; ++i ) {
+            unsigned d = static_cast<unsigned char>( p[i] ) - '0';
+            if ( d > 9 ) {
+                return false;
+            }
+            value = value * 10 + d;
+        }
+
+        for ( size_t i = head; i < n; i += 8 ) {
+            uint64_t word = load8( p + i );
+            if ( !all_digits( word ) ) {
+                return false;
+            }
+            value = value * 100000000ull + eight_digits( word );
+        }
+
+        out = value;
+        return true;
+    }
+
+    dpp::snowflake to_snowflake( std::string_view s ) {
+        dpp::snowflake id = 0;
+        parse_snowflake( s, id );
+        return id;
+    }
+
+} // namespace mybot
@@ -0,0 +1,30 @@
+#pragma once
+#include <dpp/discord.h>
+#include <string_view>
+
+namespace mybot {
+
+    /**
+     * @brief Parse a decimal snowflake as Discord sends them, e.g. "881196543516889128".
+     *
+     * Digits are validated and converted eight at a time with SWAR arithmetic on
+     * 64-bit words, so a typical 18-19 digit id costs three word operations
+     * instead of one multiply-add per character.
+     *
+     * @param s Digits only, no sign, whitespace or quotes
+     * @param out Receives the value on success, untouched on failure
+     * @return bool False if s is empty, longer than 20 digits, contains a
+     * non-digit or does not fit in 64 bits
+     */
+    bool parse_snowflake( std::string_view s, dpp::snowflake &out );
+
+    /**
+     * @brief Parse a decimal snowflake, returning 0 on failure.
+     * Discord never assigns id 0, so it doubles as "not an id".
+     *
+     * @param s Digits to parse
+     * @return dpp::snowflake Parsed id or 0
+     */
+    dpp::snowflake to_snowflake( std::string_view s );
+
+} // namespace mybot
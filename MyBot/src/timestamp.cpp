@@ -0,0 +1,144 @@
+#include "timestamp.h"
+
+namespace mybot {
+
+    namespace {
+        /* Howard Hinnant's days_from_civil / civil_from_days, valid for the proleptic Gregorian calendar */
+        int64_t days_from_civil( int64_t y, unsigned m, unsigned d ) {
+            y -= m <= 2;
+            const int64_t era = ( y >= 0 ? y : y - 399 ) / 400;
+            const unsigned yoe = static_cast<unsigned>( y - era * 400 );
+            const unsigned doy = ( 153 * ( m > 2 ? m - 3 : m + 9 ) + 2 ) / 5 + d - 1;
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + static_cast<int64_t>( doe ) - 719468;
+        }
+
+        void civil_from_days( int64_t z, int64_t &y, unsigned &m, unsigned &d ) {
+            z += 719468;
+            const int64_t era = ( z >= 0 ? z : z - 146096 ) / 146097;
+            const unsigned doe = static_cast<unsigned>( z - era * 146097 );
+            const unsigned yoe = ( doe - doe / 1460 + doe / 36524 - doe / 146096 ) / 365;
+            const unsigned doy = doe - ( 365 * yoe + yoe / 4 - yoe / 100 );
+            const unsigned mp = ( 5 * doy + 2 ) / 153;
+            d = doy - ( 153 * mp + 2 ) / 5 + 1;
+            m = mp < 10 ? mp + 3 : mp - 9;
+            y = static_cast<int64_t>( yoe ) + era * 400 + ( m <= 2 );
+        }
+
+        unsigned days_in_month( int y, int m ) {
+            static constexpr unsigned char lengths[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+            bool leap = y % 4 == 0 && ( y % 100 != 0 || y % 400 == 0 );
+            return lengths[m - 1] + ( m == 2 && leap );
+        }
+
+        /* Two digits at p, or -1 if either is not a digit */
+        int two( const char *p ) {
+            unsigned a = static_cast<unsigned char>( p[0] ) - '0';
+            unsigned b = static_cast<unsigned char>( p[1] ) - '0';
+            return ( a > 9 || b > 9 ) ? -1 : static_cast<int>( a * 10 + b );
+        }
+
+        void put2( char *p, unsigned v ) {
+            p[0] = static_cast<char>( '0' + v / 10 );
+            p[1] = static_cast<char>( '0' + v % 10 );
+        }
+    } // namespace
+
+    bool parse_iso8601( std::string_view s, int64_t &ms ) {
+        /* YYYY-MM-DDTHH:MM:SS is fixed width, everything after it is optional fraction then zone */
+        if ( s.size() < 20 || s[4] != '-' || s[7] != '-' || ( s[10] != 'T' && s[10] != ' ' ) || s[13] != ':' || s[16] != ':' ) {
+            return false;
+        }
+        const char *p = s.data();
+        int y_hi = two( p ), y_lo = two( p + 2 ), mo = two( p + 5 ), d = two( p + 8 );
+        int h = two( p + 11 ), mi = two( p + 14 ), sec = two( p + 17 );
+        if ( y_hi < 0 || y_lo < 0 || mo < 1 || mo > 12 || d < 1 || d > 31 || h < 0 || h > 23 || mi < 0 || mi > 59 || sec < 0 || sec > 60 ) {
+            return false;
+        }
+        /* days_from_civil would quietly roll e.g. February 31st over into March */
+        if ( static_cast<unsigned>( d ) > days_in_month( y_hi * 100 + y_lo, mo ) ) {
+            return false;
+        }
+
+        size_t i = 19;
+        int frac = 0;
+        if ( s[i] == '.' ) {
+            int digits = 0;
+            for ( ++i; i < s.size() && static_cast<unsigned>( s[i] - '0' ) <= 9; ++i, ++digits ) {
+                if ( digits < 3 ) {
+                    frac = frac * 10 + ( s[i] - '0' );
+                }
+            }
+            if ( digits == 0 ) {
+                return false;
+            }
+            for ( ; digits < 3; ++digits ) {
+                frac *= 10;
+            }
+        }
+
+        int64_t offset_min = 0;
+        if ( i < s.size() && s[i] == 'Z' && i + 1 == s.size() ) {
+            offset_min = 0;
+        }
+        else if ( i + 6 == s.size() && ( s[i] == '+' || s[i] == '-' ) && s[i + 3] == ':' ) {
+            int oh = two( p + i + 1 ), om = two( p + i + 4 );
+            if ( oh < 0 || om < 0 ) {
+                return false;
+            }
+            offset_min = ( s[i] == '-' ? -1 : 1 ) * ( oh * 60 + om );
+        }
+        else {
+            return false;
+        }
+
+        int64_t days = days_from_civil( y_hi * 100 + y_lo, static_cast<unsigned>( mo ), static_cast<unsigned>( d ) );
+        int64_t secs = days * 86400 + h * 3600 + mi * 60 + sec - offset_min * 60;
+        ms = secs * 1000 + frac;
+        return true;
+    }
+
+    time_t iso8601_to_time( std::string_view s ) {
+        int64_t ms = 0;
+        if ( !parse_iso8601( s, ms ) ) {
+            return 0;
+        }
+        return static_cast<time_t>( ms >= 0 ? ms / 1000 : ( ms - 999 ) / 1000 );
+    }
+
+    std::string_view format_iso8601( int64_t ms, char *out ) {
+        int64_t secs = ms >= 0 ? ms / 1000 : ( ms - 999 ) / 1000;
+        unsigned millis = static_cast<unsigned>( ms - secs * 1000 );
+        int64_t days = secs >= 0 ? secs / 86400 : ( secs - 86399 ) / 86400;
+        unsigned day_secs = static_cast<unsigned>( secs - days * 86400 );
+
+        int64_t y;
+        unsigned m, d;
+        civil_from_days( days, y, m, d );
+        unsigned year = static_cast<unsigned>( y < 0 ? 0 : ( y > 9999 ? 9999 : y ) );
+
+        put2( out, year / 100 );
+        put2( out + 2, year % 100 );
+        out[4] = '-';
+        put2( out + 5, m );
+        out[7] = '-';
+        put2( out + 8, d );
+        out[10] = 'T';
+        put2( out + 11, day_secs / 3600 );
+        out[13] = ':';
+        put2( out + 14, day_secs / 60 % 60 );
+        out[16] = ':';
+        put2( out + 17, day_secs % 60 );
+        out[19] = '.';
+        out[20] = static_cast<char>( '0' + millis / 100 );
+        put2( out + 21, millis % 100 );
+        out[23] = 'Z';
+        return std::string_view( out, iso8601_length );
+    }
+
+    void append_iso8601( std::string &out, int64_t ms ) {
+        char buffer[iso8601_length];
+        out.append( format_iso8601( ms, buffer ) );
+    }
+
+} // namespace mybot
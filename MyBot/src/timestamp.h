@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <string_view>
+
+namespace mybot {
+
+    /** Length of the text written by format_iso8601, e.g. "2021-08-30T12:34:56.789Z" */
+    constexpr size_t iso8601_length = 24;
+
+    /**
+     * @brief Parse an ISO-8601 timestamp in the fixed layout Discord uses, such as
+     * `joined_at` or `edited_timestamp`: "2021-08-30T12:34:56.789000+00:00".
+     *
+     * The fraction is optional and may have any number of digits (only
+     * milliseconds are kept), the zone is either "Z" or "+HH:MM"/"-HH:MM".
+     * No locale, strptime or mktime is involved.
+     *
+     * @param s Timestamp text
+     * @param ms Receives milliseconds since the Unix epoch (UTC) on success
+     * @return bool False if s does not match the layout or a field is out of range
+     */
+    bool parse_iso8601( std::string_view s, int64_t &ms );
+
+    /**
+     * @brief Parse an ISO-8601 timestamp to whole seconds, 0 on failure
+     *
+     * @param s Timestamp text
+     * @return time_t Seconds since the Unix epoch (UTC)
+     */
+    time_t iso8601_to_time( std::string_view s );
+
+    /**
+     * @brief Write a UTC timestamp with millisecond precision, "YYYY-MM-DDTHH:MM:SS.mmmZ"
+     *
+     * @param ms Milliseconds since the Unix epoch
+     * @param out Buffer of at least iso8601_length characters, not NUL terminated
+     * @return std::string_view View of the written text
+     */
+    std::string_view format_iso8601( int64_t ms, char *out );
+
+    /**
+     * @brief Append a UTC timestamp with millisecond precision to a string
+     *
+     * @param out String to append to
+     * @param ms Milliseconds since the Unix epoch
+     */
+    void append_iso8601( std::string &out, int64_t ms );
+
+} // namespace mybot
@@ -0,0 +1,216 @@
+#include "utf8.h"
+#include <cstdint>
+#include <cstring>
+
+#if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+    #include <emmintrin.h>
+    #define MYBOT_UTF8_SSE2
+#endif
+
+namespace mybot {
+
+    namespace {
+        constexpr uint64_t high_bits = 0x8080808080808080ull;
+
+        inline uint64_t load8( const unsigned char *p ) {
+            uint64_t v;
+            std::memcpy( &v, p, sizeof( v ) );
+            return v;
+        }
+
+        /* Number of bytes in x whose top bit is set, given only top bits may be set */
+        inline unsigned count_top_bits( uint64_t x ) {
+            return static_cast<unsigned>( ( ( x >> 7 ) * 0x0101010101010101ull ) >> 56 );
+        }
+
+        inline unsigned popcount16( unsigned m ) {
+            m = m - ( ( m >> 1 ) & 0x5555 );
+            m = ( m & 0x3333 ) + ( ( m >> 2 ) & 0x3333 );
+            m = ( m + ( m >> 4 ) ) & 0x0f0f;
+            return ( m + ( m >> 8 ) ) & 0x1f;
+        }
+
+        inline bool is_continuation( unsigned char c ) {
+            return ( c & 0xc0 ) == 0x80;
+        }
+
+        /* Code points starting in the 8 bytes at p: every byte that is not 10xxxxxx */
+        inline unsigned leads8( const unsigned char *p ) {
+            uint64_t x = load8( p );
+            return 8 - count_top_bits( x & ~( x << 1 ) & high_bits );
+        }
+
+#ifdef MYBOT_UTF8_SSE2
+        /* Code points starting in the 16 bytes at p; signed compare, continuation bytes are -128..-65 */
+        inline unsigned leads16( const unsigned char *p ) {
+            __m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i *>( p ) );
+            __m128i lead = _mm_cmpgt_epi8( v, _mm_set1_epi8( static_cast<char>( 0xbf ) ) );
+            return popcount16( static_cast<unsigned>( _mm_movemask_epi8( lead ) ) );
+        }
+#endif
+
+        /* Length of the run of ASCII bytes starting at p, at most n */
+        size_t ascii_run( const unsigned char *p, size_t n ) {
+            size_t i = 0;
+#ifdef MYBOT_UTF8_SSE2
+            for ( ; i + 16 <= n; i += 16 ) {
+                if ( _mm_movemask_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i *>( p + i ) ) ) ) {
+                    break;
+                }
+            }
+#endif
+            for ( ; i + 8 <= n; i += 8 ) {
+                if ( load8( p + i ) & high_bits ) {
+                    break;
+                }
+            }
+            while ( i < n && p[i] < 0x80 ) {
+                ++i;
+            }
+            return i;
+        }
+    } // namespace
+
+    bool utf8_valid( std::string_view s ) {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>( s.data() );
+        const size_t n = s.size();
+        size_t i = 0;
+        while ( i < n ) {
+            unsigned char b = p[i];
+            if ( b < 0x80 ) {
+                /* Only scan for a block of ASCII once we are in some; CJK text rarely has one */
+                i += ascii_run( p + i, n - i );
+                continue;
+            }
+
+            size_t need;
+            /* Bounds for the second byte exclude overlongs, surrogates and values past U+10FFFF */
+            unsigned char lo = 0x80, hi = 0xbf;
+            if ( b < 0xc2 ) {
+                return false;
+            }
+            else if ( b < 0xe0 ) {
+                need = 1;
+            }
+            else if ( b < 0xf0 ) {
+                need = 2;
+                if ( b == 0xe0 ) {
+                    lo = 0xa0;
+                }
+                else if ( b == 0xed ) {
+                    hi = 0x9f;
+                }
+            }
+            else if ( b < 0xf5 ) {
+                need = 3;
+                if ( b == 0xf0 ) {
+                    lo = 0x90;
+                }
+                else if ( b == 0xf4 ) {
+                    hi = 0x8f;
+                }
+            }
+            else {
+                return false;
+            }
+
+            if ( n - i <= need || p[i + 1] < lo || p[i + 1] > hi ) {
+                return false;
+            }
+            for ( size_t k = 2; k <= need; ++k ) {
+                if ( !is_continuation( p[i + k] ) ) {
+                    return false;
+                }
+            }
+            i += need + 1;
+        }
+        return true;
+    }
+
+    size_t utf8_length( std::string_view s ) {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>( s.data() );
+        const size_t n = s.size();
+        size_t i = 0, count = 0;
+#ifdef MYBOT_UTF8_SSE2
+        for ( ; i + 16 <= n; i += 16 ) {
+            count += leads16( p + i );
+        }
+#endif
+        for ( ; i + 8 <= n; i += 8 ) {
+            count += leads8( p + i );
+        }
+        for ( ; i < n; ++i ) {
+            count += !is_continuation( p[i] );
+        }
+        return count;
+    }
+
+    size_t utf8_advance( std::string_view s, size_t n ) {
+        const unsigned char *p = reinterpret_cast<const unsigned char *>( s.data() );
+        const size_t size = s.size();
+        size_t i = 0;
+
+        /* Skip whole blocks while the target lead byte is not inside them */
+#ifdef MYBOT_UTF8_SSE2
+        for ( unsigned c; i + 16 <= size && ( c = leads16( p + i ) ) <= n; i += 16 ) {
+            n -= c;
+        }
+#endif
+        for ( unsigned c; i + 8 <= size && ( c = leads8( p + i ) ) <= n; i += 8 ) {
+            n -= c;
+        }
+        for ( ; i < size; ++i ) {
+            if ( !is_continuation( p[i] ) ) {
+                if ( n == 0 ) {
+                    return i;
+                }
+                --n;
+            }
+        }
+        return size;
+    }
+
+    size_t utf8_floor( std::string_view s, size_t pos ) {
+        if ( pos >= s.size() ) {
+            return s.size();
+        }
+        while ( pos > 0 && is_continuation( static_cast<unsigned char>( s[pos] ) ) ) {
+            --pos;
+        }
+        return pos;
+    }
+
+    std::string_view utf8_substr( std::string_view s, size_t start, size_t length ) {
+        size_t begin = utf8_advance( s, start );
+        s.remove_prefix( begin );
+        return s.substr( 0, utf8_advance( s, length ) );
+    }
+
+    std::vector<std::string_view> split_message( std::string_view text, size_t limit ) {
+        std::vector<std::string_view> chunks;
+        if ( limit == 0 ) {
+            limit = 1;
+        }
+        while ( !text.empty() ) {
+            size_t end = utf8_advance( text, limit );
+            if ( end == text.size() ) {
+                chunks.push_back( text );
+                break;
+            }
+
+            std::string_view chunk = text.substr( 0, end );
+            size_t cut = chunk.rfind( '\n' );
+            if ( cut == std::string_view::npos || cut == 0 ) {
+                cut = chunk.rfind( ' ' );
+            }
+            size_t next = cut + 1;
+            if ( cut == std::string_view::npos || cut == 0 ) {
+                cut = next = end;
+            }
+            chunks.push_back( text.substr( 0, cut ) );
+            text.remove_prefix( next );
+        }
+        return chunks;
+    }
+
+} // namespace mybot
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+namespace mybot {
+
+    /** Discord's message content limit in characters */
+    constexpr size_t message_limit = 2000;
+
+    /**
+     * @brief Validate UTF-8, rejecting overlong forms, surrogates and code points above U+10FFFF.
+     * Runs of ASCII are skipped 16 bytes at a time (SSE2) or 8 at a time (SWAR).
+     *
+     * @param s Bytes to check
+     * @return bool True if s is well-formed UTF-8
+     */
+    bool utf8_valid( std::string_view s );
+
+    /**
+     * @brief Count code points by counting the bytes that are not continuation bytes.
+     * Equivalent to dpp::utility::utf8len for valid input, but vectorised. On invalid
+     * input every byte outside 0x80..0xBF counts as one code point and stray
+     * continuation bytes count as none, so a string made only of them gives 0.
+     *
+     * @param s UTF-8 text
+     * @return size_t Number of code points
+     */
+    size_t utf8_length( std::string_view s );
+
+    /**
+     * @brief Byte offset just past the first n code points of s, or s.size() if s is shorter
+     *
+     * @param s UTF-8 text
+     * @param n Number of code points to skip
+     * @return size_t Byte offset, always on a code point boundary
+     */
+    size_t utf8_advance( std::string_view s, size_t n );
+
+    /**
+     * @brief Largest code point boundary at or before byte offset pos
+     *
+     * @param s UTF-8 text
+     * @param pos Byte offset, clamped to s.size()
+     * @return size_t Boundary offset
+     */
+    size_t utf8_floor( std::string_view s, size_t pos );
+
+    /**
+     * @brief Substring in code points, like dpp::utility::utf8substr but returning a view
+     *
+     * @param s UTF-8 text
+     * @param start First code point
+     * @param length Maximum number of code points
+     * @return std::string_view View into s
+     */
+    std::string_view utf8_substr( std::string_view s, size_t start, size_t length );
+
+    /**
+     * @brief Cut text into chunks of at most limit code points without splitting a code point.
+     * Each cut prefers the last newline in the chunk, then the last space, and only
+     * falls back to a bare code point boundary if the chunk has neither. The
+     * separator the cut was made at is dropped.
+     *
+     * @param text UTF-8 text to split
+     * @param limit Maximum code points per chunk
+     * @return std::vector<std::string_view> Views into text, in order
+     */
+    std::vector<std::string_view> split_message( std::string_view text, size_t limit = message_limit );
+
+} // namespace mybot
@@ -0,0 +1,109 @@
+/* Allocation count test for the move-based builders in src/builders.cpp.
+ *
+ * Built by BuildersAllocTest.vcxproj in this directory, together with
+ * src/builders.cpp and src/utf8.cpp, against the same D++ headers and
+ * library as MyBot. The project runs it after linking. It exits non-zero,
+ * failing the build, if a builder allocates once the destination vector
+ * has been reserved, i.e. if an element is copied instead of moved.
+ */
+#include <dpp/dpp.h>
+#include "../src/builders.h"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace {
+    std::atomic<size_t> allocations{ 0 };
+
+    int failures = 0;
+
+    void check( bool ok, const char *what, size_t count ) {
+        std::printf( "%s %s (%zu allocations)\n", ok ? "PASS" : "FAIL", what, count );
+        failures += !ok;
+    }
+
+    dpp::component make_button( int i ) {
+        dpp::component button;
+        button.set_label( "A label long enough to live on the heap " + std::to_string( i ) ).set_type( dpp::cot_button ).set_style( dpp::cos_primary ).set_id( "a custom id long enough to be allocated " + std::to_string( i ) );
+        return button;
+    }
+
+    dpp::embed make_embed( int i ) {
+        dpp::embed e;
+        e.set_title( "An embed title long enough to be allocated " + std::to_string( i ) ).set_description( "A description that is also too long for the small string buffer" );
+        mybot::add_field( e, "Field name long enough to be allocated", "Field value long enough to be allocated", true );
+        return e;
+    }
+} // namespace
+
+void *operator new( size_t size ) {
+    allocations.fetch_add( 1, std::memory_order_relaxed );
+    if ( void *p = std::malloc( size ? size : 1 ) ) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete( void *p ) noexcept {
+    std::free( p );
+}
+
+void operator delete( void *p, size_t ) noexcept {
+    std::free( p );
+}
+
+int main() {
+    /* Five buttons into a row: only the row's first insertion may allocate, for its reserve */
+    {
+        dpp::component buttons[5];
+        for ( int i = 0; i < 5; ++i ) {
+            buttons[i] = make_button( i );
+        }
+        dpp::component row;
+        size_t before = allocations;
+        mybot::add_component( row, std::move( buttons[0] ) );
+        size_t first = allocations - before;
+        before = allocations;
+        for ( int i = 1; i < 5; ++i ) {
+            mybot::add_component( row, std::move( buttons[i] ) );
+        }
+        check( first <= 1, "first button reserves the row once", first );
+        check( allocations == before, "further buttons are moved, not copied", allocations - before );
+    }
+
+    /* Five rows into a message */
+    {
+        dpp::component rows[5];
+        for ( auto &row : rows ) {
+            mybot::add_component( row, make_button( 0 ) );
+        }
+        dpp::message m;
+        mybot::add_component( m, std::move( rows[0] ) );
+        size_t before = allocations;
+        for ( int i = 1; i < 5; ++i ) {
+            mybot::add_component( m, std::move( rows[i] ) );
+        }
+        check( allocations == before, "rows are moved, not copied", allocations - before );
+    }
+
+    /* Ten embeds into a message: dpp::embed has no implicit move, so growth would deep copy */
+    {
+        dpp::embed embeds[10];
+        for ( int i = 0; i < 10; ++i ) {
+            embeds[i] = make_embed( i );
+        }
+        dpp::message m;
+        size_t before = allocations;
+        mybot::add_embed( m, std::move( embeds[0] ) );
+        size_t first = allocations - before;
+        before = allocations;
+        for ( int i = 1; i < 10; ++i ) {
+            mybot::add_embed( m, std::move( embeds[i] ) );
+        }
+        check( first <= 1, "first embed reserves the message once", first );
+        check( allocations == before, "further embeds are moved, not copied", allocations - before );
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
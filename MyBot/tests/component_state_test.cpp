@@ -0,0 +1,83 @@
+/* Round trip and failure cases for the custom_id state encoding in src/component_state.cpp.
+ *
+ * Built by ComponentStateTest.vcxproj in this directory, together with
+ * src/component_state.cpp and src/sha256.cpp, and run after linking.
+ * It exits non-zero, failing the build, if any check fails.
+ */
+#include "../src/component_state.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    int failures = 0;
+
+    void check( bool ok, const char *what ) {
+        std::printf( "%s %s\n", ok ? "PASS" : "FAIL", what );
+        failures += !ok;
+    }
+} // namespace
+
+int main() {
+    const mybot::hmac_sha256 key( "a signing key for the tests" );
+
+    /* Signed state reads back with the widths it was written with */
+    {
+        std::string id = "count:";
+        bool written = mybot::state_writer().put_id( 123456789012345678ull ).put( 65535, 16 ).put_bool( true ).append_to( id, &key );
+        std::string_view view( id );
+        mybot::state_reader r( view, view.substr( 6 ), &key );
+        bool read = r.get_id() == 123456789012345678ull && r.get( 16 ) == 65535 && r.get_bool();
+        check( written && read && r.ok(), "signed state round trips" );
+    }
+
+    /* The tag covers the route prefix, so the state cannot be replayed on another route */
+    {
+        std::string id = "count:";
+        mybot::state_writer().put_id( 42 ).append_to( id, &key );
+        std::string other = "other:" + id.substr( 6 );
+        std::string_view view( other );
+        mybot::state_reader r( view, view.substr( 6 ), &key );
+        r.get_id();
+        check( !r.ok(), "state signed for one route is rejected on another" );
+    }
+
+    /* A changed character fails the tag */
+    {
+        std::string id = "count:";
+        mybot::state_writer().put_id( 42 ).append_to( id, &key );
+        id[7] = id[7] == 'A' ? 'B' : 'A';
+        std::string_view view( id );
+        mybot::state_reader r( view, view.substr( 6 ), &key );
+        r.get_id();
+        check( !r.ok(), "tampered state is rejected" );
+    }
+
+    /* Reading past the end is an error, not a zero */
+    {
+        std::string id = "u:";
+        mybot::state_writer().put( 5, 3 ).append_to( id );
+        std::string_view view( id );
+        mybot::state_reader r( view, view.substr( 2 ) );
+        bool first = r.get( 3 ) == 5;
+        r.get_id();
+        check( first && !r.ok(), "reading past the end fails" );
+    }
+
+    /* More fields than fit: every further put is ignored and append_to refuses */
+    {
+        mybot::state_writer w;
+        for ( int i = 0; i < 20; ++i ) {
+            w.put_id( ~0ull );
+        }
+        std::string id = "count:";
+        check( !w.append_to( id, &key ) && id == "count:", "overflowing state is refused and leaves custom_id unchanged" );
+    }
+
+    /* A prefix too long for the state and tag */
+    {
+        std::string id( 95, 'x' );
+        check( !mybot::state_writer().put_id( 1 ).append_to( id, &key ) && id.size() == 95, "state past custom_id_limit is refused" );
+    }
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -0,0 +1,79 @@
+/* Delta checks for the reaction coalescing in src/reaction_aggregator.cpp.
+ *
+ * Built by ReactionAggregatorTest.vcxproj in this directory, together with
+ * src/reaction_aggregator.cpp, against the same D++ headers and library as
+ * MyBot, and run after linking. It exits non-zero, failing the build, if
+ * any check fails. reconcile() needs a connected cluster and is not covered.
+ */
+#include <dpp/dpp.h>
+#include "../src/reaction_aggregator.h"
+#include <cstdio>
+#include <cstdlib>
+
+namespace {
+    int failures = 0;
+
+    void check( bool ok, const char *what ) {
+        std::printf( "%s %s\n", ok ? "PASS" : "FAIL", what );
+        failures += !ok;
+    }
+
+    const mybot::reaction_delta *find( const std::vector<mybot::reaction_delta> &deltas, dpp::snowflake emoji_id ) {
+        for ( const auto &d : deltas ) {
+            if ( d.emoji_id == emoji_id ) {
+                return &d;
+            }
+        }
+        return nullptr;
+    }
+} // namespace
+
+int main() {
+    std::vector<mybot::reaction_delta> delivered;
+    mybot::reaction_aggregator aggregator( [&delivered]( const std::vector<mybot::reaction_delta> &deltas ) {
+        delivered.insert( delivered.end(), deltas.begin(), deltas.end() );
+    } );
+
+    dpp::channel channel;
+    channel.id = 5;
+    dpp::emoji thumbs( "\xf0\x9f\x91\x8d" );
+    dpp::emoji custom( "pog", 77 );
+    dpp::user users[3];
+    for ( uint64_t i = 0; i < 3; ++i ) {
+        users[i].id = 1000 + i;
+    }
+
+    dpp::message_reaction_add_t add( nullptr, "" );
+    add.reacting_channel = &channel;
+    add.message_id = 100;
+    for ( dpp::user &u : users ) {
+        add.reacting_user = &u;
+        add.reacting_emoji = &thumbs;
+        aggregator.on_reaction_add( add );
+        /* A replayed add from the same user is not counted again */
+        aggregator.on_reaction_add( add );
+        add.reacting_emoji = &custom;
+        aggregator.on_reaction_add( add );
+    }
+
+    dpp::message_reaction_remove_t remove( nullptr, "" );
+    remove.reacting_channel = &channel;
+    remove.message_id = 100;
+    remove.reacting_user = &users[0];
+    remove.reacting_emoji = &custom;
+    aggregator.on_reaction_remove( remove );
+
+    aggregator.flush();
+    const mybot::reaction_delta *unicode = find( delivered, 0 );
+    const mybot::reaction_delta *named = find( delivered, 77 );
+    check( delivered.size() == 2, "one delta per emoji" );
+    check( unicode && unicode->emoji_name == thumbs.name && unicode->added == 3 && unicode->total == 3, "duplicate adds are dropped" );
+    check( named && named->emoji_name == "pog", "a custom emoji delta carries its name" );
+    check( named && named->added == 3 && named->removed == 1 && named->total == 2 && named->channel_id == 5, "adds and removes are netted per emoji" );
+
+    delivered.clear();
+    aggregator.flush();
+    check( delivered.empty(), "nothing is delivered without new events" );
+
+    return failures ? EXIT_FAILURE : EXIT_SUCCESS;
+}